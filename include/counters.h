@@ -0,0 +1,85 @@
+/**	@file   counters.h
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Hardware performance counters around the matching kernels.
+ *
+ *	Every thread opens its own perf_event_open group of cycles, instructions, cache misses and branch
+ *	misses counting only the user space. If the kernel or the container refuses the group, the
+ *	counting is switched off with one warning and the run continues. The counters missing from the
+ *	processor are reported as unavailable.
+ */
+
+#ifndef COUNTERS_H_
+#define COUNTERS_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include "util.h"
+
+/** The measured kernels. */
+typedef enum {
+	INNER_PRODUCT_KERNEL,	///< innerProduct() per frequency bin.
+	CROSS_PRODUCT_KERNEL,	///< crossProduct() per frequency bin.
+	MATCHES_KERNEL,	///< matches() per sample.
+	NUMBER_OF_KERNEL,
+} Kernel;
+
+/** The hardware events. */
+typedef enum {
+	CYCLES_COUNTER,	///< processor cycles.
+	INSTRUCTIONS_COUNTER,	///< retired instructions.
+	CACHE_MISSES_COUNTER,	///< last level cache misses.
+	BRANCH_MISSES_COUNTER,	///< mispredicted branches.
+	NUMBER_OF_COUNTER,
+} Counter;
+
+/** Values of the counters of the calling thread. */
+typedef struct {
+	uint64_t value[NUMBER_OF_COUNTER];	///< the counted events.
+} CounterValues;
+
+extern bool countersEnabled;	///< the kernels are measured.
+
+/**
+ * Reads the counters of the calling thread, opens them at the first call.
+ * @param[out] values the counters, zero if they are unavailable.
+ */
+void readCounters(CounterValues *values);
+
+/**
+ * Adds the events since the start to the kernel, thread safe.
+ * @param[in] kernel   the measured kernel.
+ * @param[in] elements number of the processed frequency bins or samples.
+ * @param[in] start    the counters at the start.
+ */
+void recordCounters(Kernel kernel, size_t elements, const CounterValues *start);
+
+/**
+ * Starts a measurement.
+ * @param[out] start the counters at the start.
+ */
+static inline void startCounters(CounterValues *start) {
+	if (countersEnabled) {
+		readCounters(start);
+	}
+}
+
+/**
+ * Ends a measurement started by startCounters().
+ * @param[in] kernel   the measured kernel.
+ * @param[in] elements number of the processed frequency bins or samples.
+ * @param[in] start    the counters at the start.
+ */
+static inline void stopCounters(Kernel kernel, size_t elements, const CounterValues *start) {
+	if (countersEnabled) {
+		recordCounters(kernel, elements, start);
+	}
+}
+
+/**
+ * Prints the calls of the kernels and the events per element.
+ * @param[in] file where to print.
+ */
+void printCounterReport(FILE *file);
+
+#endif /* COUNTERS_H_ */
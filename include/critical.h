@@ -0,0 +1,35 @@
+/**	@file   critical.h
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Search of the spin magnitude where the match of the pair crosses a threshold.
+ */
+
+#ifndef CRITICAL_H_
+#define CRITICAL_H_
+
+#include "engine.h"
+
+/** Result of the search along the spin magnitude of a blackhole. */
+typedef struct {
+	double magnitude;	///< magnitude where the worst match crosses the threshold, NAN if not bracketed.
+	double bracket[MINMAX];	///< the magnitudes of the final bracket.
+	double match[MINMAX];	///< worst matches at the ends of the initial bracket.
+	size_t evaluations;	///< number of the evaluated pairs.
+} CriticalSpin;
+
+/**
+ * Bisects the spin magnitude of the blackhole, set for both waves, between its configured value and 1
+ * until the bracket of the crossing of the worst match and the threshold is narrower than the
+ * tolerance. It needs about log2(1/tolerance) evaluations instead of the full scan of the magnitudes.
+ * @param[in,out] engine    the engine evaluating the pairs.
+ * @param[in]     pair      parameters of the two waves.
+ * @param[in]     blackhole index of the blackhole whose magnitude is searched.
+ * @param[in]     threshold the match to cross.
+ * @param[in]     tolerance width of the final bracket.
+ * @param[out]    result    the crossing.
+ * @return failure code, FAILURE if a pair couldn't be generated.
+ */
+int findCriticalSpin(Engine *engine, const Wave pair[], int blackhole, double threshold, double tolerance,
+        CriticalSpin *result);
+
+#endif /* CRITICAL_H_ */
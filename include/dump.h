@@ -0,0 +1,98 @@
+/**	@file   dump.h
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Dumps of the generated waveforms.
+ */
+
+#ifndef DUMP_H_
+#define DUMP_H_
+
+#include "dump_binary.h"
+#include "generator_lal.h"
+#include "writer.h"
+
+/** Samples selected for a dump. */
+typedef struct {
+	size_t length;	///< number of the samples of the shorter wave.
+	size_t first;	///< index of the first dumped sample.
+	size_t count;	///< number of the dumped samples.
+	size_t stride;	///< distance of the dumped samples.
+	double startTime;	///< time of the sample with index zero.
+	double samplingTime;	///< time between the consecutive samples.
+	double *taps;	///< low-pass filter of the waveforms, NULL without anti-aliasing.
+	size_t halfWidth;	///< number of the taps on each side of the centre.
+} DumpSamples;
+
+/**
+ * Selects the samples of the dump. The time window and the last seconds restrict the range, then
+ * every stride-th sample is dumped. With anti-aliasing the waveforms are filtered by a Blackman
+ * windowed sinc low-pass at the new Nyquist frequency, evaluated only at the dumped samples.
+ * @param[out] samples      the selected samples.
+ * @param[in]  option       the dump options, NULL selects every sample.
+ * @param[in]  variable     the generated values.
+ * @param[in]  samplingTime sampling time
+ */
+void selectSamples(DumpSamples *samples, const DumpOption *option, const Variable *variable, double samplingTime);
+
+/**
+ * Frees the filter of the samples.
+ * @param[in,out] samples the selected samples.
+ */
+void releaseSamples(DumpSamples *samples);
+
+void printSpins(Writer *file, Variable variable[2], Wave *wave, Analysed *analysed, const DumpSamples *samples);
+
+void printSystem(Writer *file, Variable variable[2], Wave *wave, Analysed *analysed, const DumpSamples *samples);
+/**
+ * Prints the generated values to a file.
+ * @param[in] file         where to print.
+ * @param[in] output       what to print.
+ * @param[in] wave         the waveforms parameters.
+ * @param[in] samples      the selected samples.
+ * @return success code
+ */
+int printOutput(Writer *file, Variable variable[2], Wave *wave, Analysed *analysed, const DumpSamples *samples);
+
+/**
+ * Prints the dump in the text format.
+ * @param[in] file         where to print.
+ * @param[in] kind         contents of the dump.
+ * @param[in] variable     the generated values.
+ * @param[in] wave         the waveforms parameters.
+ * @param[in] analysed     results of the analysis.
+ * @param[in] samples      the selected samples.
+ */
+void printText(Writer *file, DumpKind kind, Variable *variable, Wave *wave, Analysed *analysed,
+        const DumpSamples *samples);
+
+/**
+ * Prints the dump in the columnar binary format of dump_binary.h.
+ * @param[in] file         where to print.
+ * @param[in] kind         contents of the dump.
+ * @param[in] variable     the generated values.
+ * @param[in] wave         the waveforms parameters.
+ * @param[in] analysed     results of the analysis.
+ * @param[in] samples      the selected samples, the waveforms are stored filtered.
+ */
+void printBinary(Writer *file, DumpKind kind, Variable *variable, Wave *wave, Analysed *analysed,
+        const DumpSamples *samples);
+
+/**
+ * Returns the extension of the dump files of the format.
+ * @param[in] format the format.
+ * @return the extension without the dot.
+ */
+const char *getDumpExtension(DumpFormat format);
+
+/**
+ * Fills the generated values and the parameters from a binary dump for the text printers, the
+ * arrays point into the mapping of the dump.
+ * @param[in]  dump     the dump.
+ * @param[out] variable the generated values.
+ * @param[out] waveform the waveforms referenced by the generated values.
+ * @param[out] wave     the waveforms parameters.
+ * @param[out] analysed results of the analysis.
+ */
+void viewDump(const DumpFile *dump, Variable *variable, Waveform *waveform, Wave wave[], Analysed *analysed);
+
+#endif /* DUMP_H_ */
@@ -0,0 +1,138 @@
+/**	@file   dump_binary.h
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Columnar binary dump format and its memory mapped reader.
+ *
+ *	The file starts with a DumpHeader carrying the parameters of the two waves and the results of
+ *	the analysis, the columns follow from dataOffset, each stored contiguously as rows native doubles.
+ *	The time of a row is startTime + row * timeStep. The reader depends only on the C library, so
+ *	the plotting tools can link it alone.
+ */
+
+#ifndef DUMP_BINARY_H_
+#define DUMP_BINARY_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define DUMP_MAGIC "GWDUMP\r\n"	///< first bytes of the file, the line ends catch the text mode transfers.
+#define DUMP_BYTE_ORDER 0x01020304u	///< written natively, the reader rejects the foreign byte order.
+
+/** Constants of the binary dumps. */
+enum {
+	DUMP_VERSION = 1,	///< version of the layout.
+	DUMP_MAGIC_LENGTH = 8,	///< length of the magic bytes.
+	DUMP_COLUMNS = 12,	///< maximal number of the columns.
+	DUMP_NAME = 16,	///< length of a column name.
+	DUMP_TEXT = 64,	///< length of the name of the spin method.
+	DUMP_WAVES = 2,	///< number of the waves.
+	DUMP_BLACKHOLES = 2,	///< number of the blackholes of a binary.
+	DUMP_MATCHES = 3,	///< number of the matches: worst, typical, best.
+	DUMP_ALIGNMENT = 64,	///< alignment of the columns.
+};
+
+/** Contents of the dumps. */
+typedef enum {
+	SPIN_DUMP,	///< spin vectors.
+	SYSTEM_DUMP,	///< orbital plane vectors.
+	WAVE_DUMP,	///< waveforms, frequencies and phases.
+	NUMBER_OF_DUMP,
+} DumpKind;
+
+/** Parameters of a wave, the angles are in radians. */
+typedef struct {
+	double mass[DUMP_BLACKHOLES];	///< masses of the blackholes.
+	double magnitude[DUMP_BLACKHOLES];	///< magnitudes of the spins.
+	double inclination[DUMP_BLACKHOLES];	///< inclinations of the spins.
+	double azimuth[DUMP_BLACKHOLES];	///< azimuths of the spins.
+	char spin[DUMP_TEXT];	///< spin contribution of the method.
+	int32_t phase;	///< double of the PN order in phase.
+	int32_t amplitude;	///< double of the PN order in amplitude.
+} DumpWave;
+
+/** Results of the analysis. */
+typedef struct {
+	double match[DUMP_MATCHES];	///< worst, typical and best matches.
+	uint64_t period[DUMP_WAVES];	///< number of the periods.
+	double relativePeriod;	///< relative difference of the periods.
+	double length[DUMP_WAVES];	///< lengths of the waves.
+	double relativeLength;	///< relative difference of the lengths.
+} DumpAnalysed;
+
+/** Header of the binary dump, every field is naturally aligned without padding. */
+typedef struct {
+	char magic[DUMP_MAGIC_LENGTH];	///< DUMP_MAGIC.
+	uint32_t version;	///< DUMP_VERSION.
+	uint32_t kind;	///< DumpKind of the contents.
+	uint32_t byteOrder;	///< DUMP_BYTE_ORDER.
+	uint32_t columns;	///< number of the columns.
+	uint64_t rows;	///< number of the rows.
+	uint64_t dataOffset;	///< offset of the first column from the beginning of the file.
+	double startTime;	///< time of the first row.
+	double timeStep;	///< time between the rows.
+	DumpWave wave[DUMP_WAVES];	///< parameters of the waves.
+	DumpAnalysed analysed;	///< results of the analysis.
+	char column[DUMP_COLUMNS][DUMP_NAME];	///< names of the columns.
+} DumpHeader;
+
+/** Memory mapped binary dump. */
+typedef struct {
+	const DumpHeader *header;	///< the header at the beginning of the mapping.
+	const char *map;	///< the mapped file.
+	size_t size;	///< size of the mapping.
+} DumpFile;
+
+/**
+ * Returns the offset of the first column.
+ * @return the size of the header rounded up to the alignment.
+ */
+static inline uint64_t getDumpDataOffset(void) {
+	return ((sizeof(DumpHeader) + DUMP_ALIGNMENT - 1) / DUMP_ALIGNMENT * DUMP_ALIGNMENT);
+}
+
+/**
+ * Returns the name of the contents, used in the file names and the configuration.
+ * @param[in] kind contents of the dump.
+ * @return "spin", "system" or "wave".
+ */
+const char *getDumpName(DumpKind kind);
+
+/**
+ * Maps the binary dump into the memory and checks its header.
+ * @param[in] path path of the file.
+ * @return the dump or NULL on error, the reason is printed to the standard error.
+ */
+DumpFile *openDump(const char *path);
+
+/**
+ * Unmaps the dump.
+ * @param[in,out] dump the dump.
+ */
+void closeDump(DumpFile **dump);
+
+/**
+ * Returns the column.
+ * @param[in] dump   the dump.
+ * @param[in] column index of the column.
+ * @return the values of the column, header->rows long, or NULL if there is no such column.
+ */
+const double *getDumpColumn(const DumpFile *dump, size_t column);
+
+/**
+ * Returns the column with the given name.
+ * @param[in] dump the dump.
+ * @param[in] name name of the column.
+ * @return the values of the column or NULL if there is no such column.
+ */
+const double *findDumpColumn(const DumpFile *dump, const char *name);
+
+/**
+ * Returns the time of the row.
+ * @param[in] dump the dump.
+ * @param[in] row  index of the row.
+ * @return the time.
+ */
+double getDumpTime(const DumpFile *dump, size_t row);
+
+#endif /* DUMP_BINARY_H_ */
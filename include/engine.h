@@ -0,0 +1,69 @@
+/**	@file   engine.h
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Generation and matching of pairs for the programs linking the library.
+ *
+ *	An engine holds the band and sampling and the matching buffers, it uses no global state and no
+ *	files, so the calls after the first one of a length only generate and transform. An engine is
+ *	not thread safe, the threads use their own engines.
+ *
+ *		JobPlan plan;
+ *		parsePlan("base.conf", &plan);
+ *		Engine *engine = createEngine(&plan.parameter);
+ *		Analysed analysed;
+ *		matchWithEngine(engine, plan.exact[0].pair, &analysed);
+ *		destroyEngine(&engine);
+ *		cleanPlan(&plan);
+ */
+
+#ifndef ENGINE_H_
+#define ENGINE_H_
+
+#include "parser_confuse.h"
+#include "match_fftw.h"
+
+typedef struct Engine Engine;
+
+/**
+ * Creates an engine.
+ * @param[in] parameter band and sampling of the pairs, copied.
+ * @return the engine or NULL if out of memory.
+ */
+Engine *createEngine(const Parameter *parameter);
+
+/**
+ * Generates the pair and computes its matches, periods and lengths.
+ * @param[in,out] engine   the engine.
+ * @param[in]     pair     parameters of the two waves.
+ * @param[out]    analysed the results, zero on failure.
+ * @return failure code, FAILURE if a wave couldn't be generated.
+ */
+int matchWithEngine(Engine *engine, const Wave pair[], Analysed *analysed);
+
+/**
+ * Generates the pair once and computes the matches of its detector responses for every orientation,
+ * besides the matches of matchWithEngine.
+ * @param[in,out] engine   the engine.
+ * @param[in]     pair     parameters of the two waves.
+ * @param[in]     count    number of the orientations.
+ * @param[in]     antenna  the orientations.
+ * @param[out]    match    the matches of the orientations, zero on failure.
+ * @param[out]    analysed the results, zero on failure.
+ * @return failure code, FAILURE if a wave couldn't be generated.
+ */
+int projectWithEngine(Engine *engine, const Wave pair[], size_t count, const Antenna antenna[], double match[],
+        Analysed *analysed);
+
+/**
+ * Evaluates the pairs in order.
+ * @param[in,out] engine   the engine.
+ * @param[in]     count    number of the pairs.
+ * @param[in]     job      the pairs.
+ * @param[out]    analysed the results of the pairs.
+ * @return number of the pairs that failed.
+ */
+size_t matchBatchWithEngine(Engine *engine, size_t count, const PairJob job[], Analysed analysed[]);
+
+void destroyEngine(Engine **engine);
+
+#endif /* ENGINE_H_ */
@@ -0,0 +1,59 @@
+/**	@file   fitting.h
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Fitting factor of a template family to a target wave.
+ *
+ *	The fitting factor is the largest match of the target over the binaries of the template family,
+ *	here over the masses and the spin magnitudes of the template; its spin angles, orbit, distance and
+ *	method stay fixed. The maximum is searched by Nelder–Mead simplices, the first one started from the
+ *	template itself, the others from random points between the bounds, the restarts run in parallel.
+ *	The target is generated, transformed and orthonormalised once per thread, only the templates are
+ *	generated and transformed for the evaluations. Every restart starts with the buffers padded to the
+ *	estimated length of the longest template of the bounds, a longer template grows them only until the
+ *	end of the restart, so a restart gives the same result on any thread.
+ */
+
+#ifndef FITTING_H_
+#define FITTING_H_
+
+#include <stdint.h>
+#include "parser_confuse.h"
+#include "match_fftw.h"
+
+/** The searched fields of the template. */
+enum {
+	FIT_MASS1, FIT_MASS2, FIT_MAGNITUDE1, FIT_MAGNITUDE2, FIT_DIMENSION,
+};
+
+/** Settings of the search. */
+typedef struct {
+	size_t restarts;	///< number of the simplices, the first one starts from the template.
+	size_t threads;	///< number of the threads running the restarts.
+	size_t evaluations;	///< maximal number of the evaluations of a restart.
+	double tolerance;	///< a restart stops when the matches of its vertices differ less than this.
+	uint64_t seed;	///< seed of the random starting points, restart r uses the stream r.
+	int kind;	///< the maximised match, WORST, TYPICAL or BEST.
+	double bound[MINMAX][FIT_DIMENSION];	///< lower and upper bounds of the searched fields.
+} FitOption;
+
+/** Result of the search. */
+typedef struct {
+	Wave template;	///< the template of the largest match.
+	double match;	///< the fitting factor.
+	size_t restart;	///< index of the restart finding the template.
+	size_t evaluations;	///< number of the generated templates.
+	size_t cached;	///< number of the evaluations answered from the cache of the restarts.
+} FittingFactor;
+
+/**
+ * Searches the fitting factor of the target. The result is the same for any number of threads.
+ * @param[in]  parameter band and sampling.
+ * @param[in]  pair      the target and the template, the template gives the fixed fields.
+ * @param[in]  option    settings of the search.
+ * @param[out] result    the best template and its match.
+ * @return failure code, FAILURE if the target couldn't be generated.
+ */
+int findFittingFactor(const Parameter *parameter, const Wave pair[], const FitOption *option,
+        FittingFactor *result);
+
+#endif /* FITTING_H_ */
@@ -0,0 +1,52 @@
+/**	@file   generator.h
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Backends generating the waves.
+ */
+
+#ifndef GENERATOR_H_
+#define GENERATOR_H_
+
+#include "parser_confuse.h"
+
+/** Polarisations of a wave. */
+enum {
+	HP, HC, WAVE,
+};
+
+/** Series of one generated wave, the arrays belong to the backend. */
+typedef struct {
+	size_t length;	///< number of the samples.
+	double *h[WAVE];	///< plus and cross polarisations.
+	double *V;	///< post-Newtonian parameter.
+	double *Phi;	///< orbital phase.
+	double *S1[DIMENSION];	///< spin of the first blackhole.
+	double *S2[DIMENSION];	///< spin of the second blackhole.
+	double *E1[DIMENSION];	///< first axis of the orbital plane.
+	double *E3[DIMENSION];	///< normal of the orbital plane.
+	void *handle;	///< data of the backend to release the series.
+} WaveSeries;
+
+/** A waveform generating backend. */
+typedef struct {
+	const char *name;	///< name of the backend in the method section.
+	/**
+	 * Generates the wave from the initial frequency to the end of the inspiral.
+	 * @param[in]  wave             parameters of the wave, the spin components are set.
+	 * @param[in]  initialFrequency starting frequency
+	 * @param[in]  samplingTime     sampling time
+	 * @param[out] series           the generated series.
+	 * @return failure code
+	 */
+	int (*generate)(const Wave *wave, double initialFrequency, double samplingTime, WaveSeries *series);
+	/**
+	 * Frees the series.
+	 * @param[in,out] series the generated series.
+	 */
+	void (*release)(WaveSeries *series);
+} GeneratorBackend;
+
+extern const GeneratorBackend lalGenerator;	///< SpinQuadTaylor of LALSimulation.
+extern const GeneratorBackend chirpGenerator;	///< analytic restricted post-Newtonian chirp.
+
+#endif /* GENERATOR_H_ */
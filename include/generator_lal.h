@@ -8,6 +8,7 @@
 #define GENERATOR_LAL_H_
 
 #include <stdio.h>
+#include "generator.h"
 #include "parser_confuse.h"
 #include "match_fftw.h"
 
@@ -34,22 +35,62 @@ typedef struct {
 Variable* generateWaveformPair(Wave parameter[], double initialFrequency, double samplingTime);
 
 /**
- * Frees the allocated memory.
- * @param[in] output memories to free.
+ * Generates one wave without copying its series.
+ * @param[in,out] wave             waveform parameters, the spin components are set.
+ * @param[in]     initialFrequency starting frequency
+ * @param[in]     samplingTime     sampling time
+ * @param[out]    series           the series of the backend, released by releaseWave.
+ * @return failure code
  */
-void destroyOutput(Variable **output);
+int generateWave(Wave *wave, double initialFrequency, double samplingTime, WaveSeries *series);
+
+/**
+ * Frees the series generated by generateWave.
+ * @param[in]     wave   waveform parameters.
+ * @param[in,out] series the series.
+ */
+void releaseWave(const Wave *wave, WaveSeries *series);
+
+/**
+ * Finds the backend of the name given in the method section.
+ * @param[in]  name      name of the backend, "lal" or "chirp".
+ * @param[out] generator the backend.
+ * @return failure code, FAILURE for an unknown name.
+ */
+int findGenerator(const char *name, GeneratorKind *generator);
+
+/**
+ * Returns the name of the backend.
+ * @param[in] generator the backend.
+ * @return the name, as in the method section.
+ */
+const char *getGeneratorName(GeneratorKind generator);
+
+/**
+ * Estimates the number of the samples of the waveform from the Newtonian chirp time.
+ * \f[
+ * 	\tau_0=\frac{5}{256}\left(\pi f_0\right)^{-8/3}\left(\frac{G\mathcal{M}}{c^3}\right)^{-5/3}
+ * \f]
+ * @param[in] wave             waveform parameters.
+ * @param[in] initialFrequency starting frequency
+ * @param[in] samplingTime     sampling time
+ * @return estimated length
+ */
+double estimateLength(const Wave *wave, double initialFrequency, double samplingTime);
 
-void printSpins(FILE *file, Variable variable[2], Wave *wave, Analysed *analysed, double samplingTime);
+/**
+ * Predicts the peak memory of generating and matching a pair. It is the larger of the generation
+ * phase (LAL series with their growth reserve, the Variable arrays and the Waveform) and the matching
+ * phase (the Variable arrays, the Waveform and the FFT buffers).
+ * @param[in] length length of the longer wave.
+ * @return predicted peak memory in bytes.
+ */
+double estimateMemory(double length);
 
-void printSystem(FILE *file, Variable variable[2], Wave *wave, Analysed *analysed, double samplingTime);
 /**
- * Prints the generated values to a file.
- * @param[in] file         where to print.
- * @param[in] output       what to print.
- * @param[in] wave         the waveforms parameters.
- * @param[in] samplingTime sampling time
- * @return success code
+ * Frees the allocated memory.
+ * @param[in] output memories to free.
  */
-int printOutput(FILE *file, Variable variable[2], Wave *wave, Analysed *analysed, double samplingTime);
+void destroyOutput(Variable **output);
 
 #endif /* GENERATOR_LAL_H_ */
@@ -7,6 +7,9 @@
 #ifndef MATCH_FFTW_H_
 #define MATCH_FFTW_H_
 
+#include <stdbool.h>
+#include <stddef.h>
+
 enum {
 	HP1, HC1, HP2, HC2, COMPONENT, FIRST_WAVE = 0, SECOND_WAVE, NUMBER_OF_WAVE,
 };
@@ -34,16 +37,180 @@ typedef struct {
 	double relativeLength;
 } Analysed;
 
+/**
+ * Calculates the noise weighted inner product of the spectra between the indices, the complex
+ * values are the fftw_complex of the C99 complex.h.
+ */
+double innerProduct(double _Complex left[], double _Complex right[], double norm[], size_t minIndex, size_t maxIndex);
+
+/**
+ * Normalises the plus and cross spectra and orthogonalises the cross one to the plus one.
+ */
+void orthonormalise(double _Complex *plus, double _Complex *cross, double *norm, size_t minIndex, size_t maxIndex,
+        size_t length, double _Complex *out);
+
 void indexFromFrequency(double min, double max, double step, size_t *minIndex, size_t *maxIndex);
 
+/**
+ * Buffers, FFTW plans and noise spectrum of the matching. The functions below without a context use
+ * the context of the calling thread, the ones with a context touch nothing else, so a caller may
+ * keep one context per thread and reuse it for any number of pairs.
+ */
+typedef struct MatchContext MatchContext;
+
+/**
+ * Creates an empty context which keeps its buffers, plans and noise spectrum between the pairs.
+ * @return the context or NULL if out of memory.
+ */
+MatchContext *createMatchContext(void);
+
+void destroyMatchContext(MatchContext **context);
+
+/**
+ * Points the context to the waveform, the plans are made only if the length changed.
+ */
+void prepareMatch(MatchContext *context, Waveform *waveform);
+
+/**
+ * Replaces the noise curve of the context, the default is aLIGO high frequency of LALSimulation. A
+ * curve given here is evaluated at the frequencies of the bins without LAL, so the matches don't
+ * depend on the version of LALSimulation.
+ * @param[in,out] context the context.
+ * @param[in]     noise   the one-sided noise spectral density of the frequency, NULL for the default.
+ */
+void setNoiseCurve(MatchContext *context, double (*noise)(double));
+
+/**
+ * Fills the noise spectrum of the band, unless the context holds it already.
+ */
+void prepareNoise(MatchContext *context, double initialFrequency, double samplingFrequency);
+
+/**
+ * Keeps the orthonormalised spectra of the first wave between the calls of computeMatches, so only the
+ * second wave is transformed and orthonormalised while the first one, the waveform, the length, the
+ * noise spectrum and the band stay the same. The caller changes only the second wave in the buffers.
+ * @param[in,out] context the context.
+ * @param[in]     hold    keep the first wave.
+ */
+void holdFirstWave(MatchContext *context, bool hold);
+
+void computeMatches(MatchContext *context, size_t minIndex, size_t maxIndex, Analysed *analysed);
+
+void computePeriods(MatchContext *context, double samplingTime, Analysed *analysed);
+
+/**
+ * Detaches the waveform, the buffers are freed unless the context keeps them.
+ */
+void finishMatch(MatchContext *context);
+
+/** Antenna pattern of a detector orientation, the response is F+ h+ + Fx hx. */
+typedef struct {
+	double plus;	///< F+.
+	double cross;	///< Fx.
+} Antenna;
+
+/** The detector sites of the network. */
+typedef enum {
+	HANFORD, LIVINGSTON, VIRGO, KAGRA, NUMBER_OF_SITE,
+} DetectorSite;
+
+/** A detector of the network: its site determines the noise curve. */
+typedef struct {
+	DetectorSite site;	///< the site.
+	Antenna antenna;	///< the antenna pattern of the source.
+} Detector;
+
+/**
+ * Returns the name of the detector site, H1, L1, V1 or K1.
+ * @param[in] site the site.
+ * @return the name.
+ */
+const char *getSiteName(DetectorSite site);
+
+/**
+ * Computes the antenna pattern of the detector for the sky position.
+ * @param[in]  site           the detector.
+ * @param[in]  rightAscension right ascension of the source in radian.
+ * @param[in]  declination    declination of the source in radian.
+ * @param[in]  polarisation   polarisation angle in radian.
+ * @param[in]  gmst           Greenwich mean sidereal time in radian.
+ * @param[out] antenna        the antenna pattern.
+ */
+void siteAntennaFromSky(DetectorSite site, double rightAscension, double declination, double polarisation,
+        double gmst, Antenna *antenna);
+
+/**
+ * Computes the antenna pattern of the LIGO Hanford detector for the sky position.
+ * @param[in]  rightAscension right ascension of the source in radian.
+ * @param[in]  declination    declination of the source in radian.
+ * @param[in]  polarisation   polarisation angle in radian.
+ * @param[in]  gmst           Greenwich mean sidereal time in radian.
+ * @param[out] antenna        the antenna pattern.
+ */
+void antennaFromSky(double rightAscension, double declination, double polarisation, double gmst, Antenna *antenna);
+
+/**
+ * Computes the matches of the detector responses of the two waves, maximised over the time and phase
+ * shift, for every orientation. The projection is linear, so the polarisations are transformed and
+ * correlated once per pair, an orientation only combines the four correlations. It leaves the
+ * spectra untouched, computeMatches afterwards reuses them.
+ * @param[in,out] context  the context prepared for the pair.
+ * @param[in]     minIndex starting index of the band.
+ * @param[in]     maxIndex ending index of the band.
+ * @param[in]     count    number of the orientations.
+ * @param[in]     antenna  the orientations.
+ * @param[out]    match    the matches of the orientations.
+ */
+void computeProjectedMatches(MatchContext *context, size_t minIndex, size_t maxIndex, size_t count,
+        const Antenna antenna[], double match[]);
+
+/**
+ * Computes the network match of the detector responses of the two waves. The spectra are transformed
+ * once, the cross spectra of the detectors are weighted by their own noise and summed, and the peak
+ * of the single inverse transform of the sum is normalised by the network norms of the waves.
+ * \f[
+ * 	M=\max_{t}\frac{\left|\sum_d\inProd{H_{1,d}}{H_{2,d}e^{2\pi ift}}_d\right|}
+ * 	{\sqrt{\sum_d\inProd{H_{1,d}}{H_{1,d}}_d\sum_d\inProd{H_{2,d}}{H_{2,d}}_d}}
+ * \f]
+ * The arrival time differences of the detectors are the same for both waves, so they do not change
+ * the match and are not applied. The spectra are left untouched for computeMatches.
+ * @param[in,out] context           the context prepared for the pair.
+ * @param[in]     minIndex          starting index of the band.
+ * @param[in]     maxIndex          ending index of the band.
+ * @param[in]     initialFrequency  initial frequency of the noise spectra.
+ * @param[in]     samplingFrequency sampling frequency.
+ * @param[in]     count             number of the detectors.
+ * @param[in]     detector          the detectors.
+ * @return the network match.
+ */
+double computeNetworkMatch(MatchContext *context, size_t minIndex, size_t maxIndex, double initialFrequency,
+        double samplingFrequency, size_t count, const Detector detector[]);
+
+/**
+ * Keeps the buffers, the FFTW plans and the noise spectrum of the thread after cleanMatch, the next
+ * initMatch of the same length and generatePSD of the same band reuse them. Set before starting the
+ * threads; the memory of a thread is released by releaseMatchCache.
+ */
+extern bool matchCacheEnabled;
+
 void generatePSD(double initialFrequency, double samplingFrequency);
 
 void initMatch(Waveform *waveform);
 
 void cleanMatch(void);
 
+/**
+ * Frees the buffers and the plans kept for the calling thread.
+ */
+void releaseMatchCache(void);
+
 void calcMatches(size_t minIndex, size_t maxIndex, Analysed *analysed);
 
+void calcProjectedMatches(size_t minIndex, size_t maxIndex, size_t count, const Antenna antenna[], double match[]);
+
+double calcNetworkMatch(size_t minIndex, size_t maxIndex, double initialFrequency, double samplingFrequency,
+        size_t count, const Detector detector[]);
+
 void countPeriods(double samplingTime, Analysed *analysed);
 
 #endif /* MATCH_FFTW_H_ */
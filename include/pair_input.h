@@ -0,0 +1,110 @@
+/**	@file   pair_input.h
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Streaming input of the pairs from CSV or binary files.
+ *
+ *	A row describes one binary and the methods of its two waves. The CSV columns are
+ *
+ *		name, m1, m2, chi1, inclination1, azimuth1, chi2, inclination2, azimuth2, inclination, distance,
+ *		spin1, phase1, amplitude1, spin2, phase2, amplitude2[, initialFrequency, endingFrequency]
+ *
+ *	with the angles in degrees, the lines starting with '#' are skipped, and so is the first other line
+ *	if it starts with "name", as the header. A missing or zero band takes the configured one, the rows
+ *	with any other number of columns are malformed. The waves are generated by the backend of the wave
+ *	titled "default" of the configuration. The binary file is a PairHeader followed by native PairRecords,
+ *	convert writes it from the CSV. The reader holds only the rows
+ *	of the current chunk, so the memory does not grow with the input.
+ */
+
+#ifndef PAIR_INPUT_H_
+#define PAIR_INPUT_H_
+
+#include <stdint.h>
+#include "parser_confuse.h"
+
+#define PAIR_MAGIC "GWPAIRS\n"	///< first bytes of the binary pair file.
+
+/** Constants of the pair files. */
+enum {
+	PAIR_VERSION = 1,	///< version of the binary layout.
+	PAIR_MAGIC_LENGTH = 8,	///< length of the magic bytes.
+	PAIR_NAME = 32,	///< length of the name of a pair.
+	PAIR_SPIN = 16,	///< length of the spin contribution of a method.
+	PAIR_CHUNK = 4096,	///< number of the rows read and evaluated together.
+};
+
+/** Header of the binary pair file. */
+typedef struct {
+	char magic[PAIR_MAGIC_LENGTH];	///< PAIR_MAGIC.
+	uint32_t version;	///< PAIR_VERSION.
+	uint32_t byteOrder;	///< DUMP_BYTE_ORDER.
+	uint64_t recordSize;	///< sizeof(PairRecord).
+} PairHeader;
+
+/** A row of the pair file, the angles are in degrees, every field is naturally aligned. */
+typedef struct {
+	char name[PAIR_NAME];	///< name of the pair.
+	double mass[2];	///< masses of the blackholes.
+	double magnitude[2];	///< magnitudes of the spins.
+	double inclination[2];	///< inclinations of the spins.
+	double azimuth[2];	///< azimuths of the spins.
+	double orbitInclination;	///< inclination of the orbital plane.
+	double distance;	///< distance of the source.
+	char spin[2][PAIR_SPIN];	///< spin contributions of the methods of the waves.
+	int32_t phase[2];	///< double of the PN orders in phase.
+	int32_t amplitude[2];	///< double of the PN orders in amplitude.
+	double band[MINMAX];	///< initial and ending frequency, zero takes the configured.
+} PairRecord;
+
+typedef struct PairReader PairReader;
+
+/**
+ * Opens the pair file, the binary files are recognised by their magic.
+ * @param[in] path path of the file.
+ * @return the reader or NULL on error, the reason is printed to the standard error.
+ */
+PairReader *openPairReader(const char *path);
+
+/**
+ * Reads the next rows.
+ * @param[in,out] reader   the reader.
+ * @param[in]     capacity maximal number of the rows.
+ * @param[out]    record   the rows.
+ * @return number of the rows, 0 at the end of the file or on error.
+ */
+size_t readPairRecords(PairReader *reader, size_t capacity, PairRecord record[]);
+
+/**
+ * Closes the file.
+ * @param[in,out] reader the reader.
+ * @return failure code, FAILURE if any row was malformed or the file couldn't be read.
+ */
+int closePairReader(PairReader **reader);
+
+/**
+ * Parses a CSV line into the row.
+ * @param[in]  line   the line, modified.
+ * @param[out] record the row.
+ * @return failure code, FAILURE if a field or the number of the columns is wrong.
+ */
+int parsePairLine(char *line, PairRecord *record);
+
+/**
+ * Converts the row to the parameters of the pair, the waves are generated by the backend of the
+ * default wave of the configuration.
+ * @param[in]  record the row.
+ * @param[in]  plan   the configuration, with the band, the sampling and the default wave.
+ * @param[out] job    the pair.
+ * @param[out] band   the band and sampling of the pair.
+ */
+void fillPairJob(const PairRecord *record, const JobPlan *plan, PairJob *job, Parameter *band);
+
+/**
+ * Writes the rows of the pair file into a binary pair file.
+ * @param[in] input  path of the CSV or binary pair file.
+ * @param[in] output path of the binary pair file.
+ * @return failure code
+ */
+int convertPairs(const char *input, const char *output);
+
+#endif /* PAIR_INPUT_H_ */
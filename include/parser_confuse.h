@@ -7,6 +7,8 @@
 #ifndef PARSER_CONFUSE_H_
 #define PARSER_CONFUSE_H_
 
+#include <stdio.h>
+#include "dump_binary.h"
 #include "util.h"
 #include "util_math.h"
 
@@ -39,11 +41,19 @@ typedef struct {
 	double distance;	///< distance of the source from the detector.
 } Binary;
 
+/** Backends generating the waveforms. */
+typedef enum {
+	LAL_GENERATOR,	///< SpinQuadTaylor of LALSimulation.
+	CHIRP_GENERATOR,	///< built-in analytic restricted post-Newtonian chirp.
+	NUMBER_OF_GENERATOR,
+} GeneratorKind;
+
 /** Waveform generation method. */
 typedef struct {
 	char spin[STRING_LENGTH];	///< spin contribution to use.
 	int phase;	///< double of the PN order in phase.
 	int amplitude;	///< double of the PN order in amplitude.
+	GeneratorKind generator;	///< backend generating the waveform.
 } Method;
 
 /** Waveform parameters. */
@@ -53,11 +63,32 @@ typedef struct {
 	string name;	///< name of the generated waveform.
 } Wave;
 
+/** A pair of waves with every parameter resolved. */
 typedef struct {
-	size_t length;	///< number of waveform pairs.
-	Wave *wave;	///< default wave parameters.
-	string *name;	///< name of the waveform pairs.
-} WavePair;
+	Wave pair[2];	///< parameters of the two waves.
+	string name;	///< title of the section of the pair.
+} PairJob;
+
+/** Format of the waveform dumps. */
+typedef enum {
+	TEXT_FORMAT,	///< whitespace separated columns with '#' headers.
+	BINARY_FORMAT,	///< columnar binary described in dump_binary.h.
+} DumpFormat;
+
+/** Destination of the results of the exact pairs. */
+typedef enum {
+	FULL_SINK,	///< dumps every sample of the pairs.
+	SUMMARY_SINK,	///< writes one row of results per pair.
+	NULL_SINK,	///< discards the results, for measuring the throughput.
+} OutputSink;
+
+/** Sample selection of a dump. */
+typedef struct {
+	size_t stride;	///< distance of the dumped samples, one dumps every sample.
+	bool antiAlias;	///< low-pass filters the waveforms before the decimation.
+	double window[MINMAX];	///< time window in seconds, the end is ignored if not after the beginning.
+	double last;	///< dumps only the last seconds before the end of the shorter wave if positive.
+} DumpOption;
 
 /** Parameters to generate waveforms. */
 typedef struct {
@@ -65,34 +96,59 @@ typedef struct {
 	double endingFrequency;	///< ending frequency.
 	double samplingFrequency;	///< sampling frequency.
 	double samplingTime;	///< sampling time.
-	WavePair *exact;
-	Wave boundary[MINMAX];
-	WavePair *step;
-	size_t numberOfStep[BH];
-	bool gen[GEN];
-	bool exactTrue;
-	bool stepTrue;
+	DumpFormat format;	///< format of the waveform dumps.
+	DumpOption dump[NUMBER_OF_DUMP];	///< sample selection of the dumps.
+	OutputSink sink;	///< destination of the results of the exact pairs.
 } Parameter;
 
 /**
- * Initialise the parser.
+ * Everything the runs need from the configuration. It is filled by a single parse, the omitted
+ * parameters of the waves already defaulted, and only read afterwards, so the workers share it.
  */
-int initParser(char *file, Parameter *parameter, string outputDir);
-
-int parseWaves(char *file, Parameter *parameter);
+typedef struct {
+	Parameter parameter;	///< band, sampling and output settings.
+	string outputDir;	///< output directory.
+	Wave defaultWave;	///< the wave titled "default" or the built-in one, the pair files take its generator.
+	bool exactTrue;	///< the exact pairs are evaluated.
+	size_t exactLength;	///< number of the exact pairs.
+	PairJob *exact;	///< the exact pairs.
+	bool stepTrue;	///< the statistic is evaluated.
+	Wave boundary[MINMAX];	///< lower and upper bounds of the stepped values.
+	size_t numberOfStep[BH];	///< number of the steps of the values of the blackholes.
+	bool gen[GEN];	///< the stepped variables.
+	size_t stepLength;	///< number of the stepped pairs.
+	PairJob *step;	///< the stepped pairs, the values of the stepped variable are overwritten.
+} JobPlan;
 
-int parseStep(char *file, Parameter *parameter);
+/**
+ * Parses the configuration file into the plan. A wave takes its omitted parameters from the wave
+ * titled "default". The sections titled "default", of the wave and of the bounds of the statistic,
+ * default to spin magnitudes 1, orbital inclination 10° and amplitude order 0; without a default wave
+ * the waves default to spin magnitudes 0, inclination 0 and amplitude order 2.
+ * @param[in]  file path of the configuration.
+ * @param[out] plan the plan.
+ * @return failure code
+ */
+int parsePlan(const char *file, JobPlan *plan);
 
-void cleanParameter(Parameter *parameter);
+/**
+ * Frees the pairs of the plan.
+ * @param[in,out] plan the plan.
+ */
+void cleanPlan(JobPlan *plan);
 
 /**
  * Prints the paramters.
- * @param[in] file      where to print.
- * @param[in] parameter to print.
- * @param[in] from
- * @param[in] to
- * @return
+ * @param[in] file where to print.
+ * @param[in] plan to print.
+ * @return failure code
  */
-int printParameter(FILE *file, Parameter *parameter, int from, int to);
+int printPlan(FILE *file, const JobPlan *plan);
+
+#ifdef TEST
+
+bool isOK_parsePlan(void);
+
+#endif	// TEST
 
 #endif /* PARSER_CONFUSE_H_ */
@@ -0,0 +1,57 @@
+/**	@file   pipeline.h
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Overlapped generation, matching and writing of the jobs.
+ */
+
+#ifndef PIPELINE_H_
+#define PIPELINE_H_
+
+#include "scheduler.h"
+
+/** The stages of the pipeline. */
+typedef struct {
+	/**
+	 * Generates the data of the job, runs in the generator pool.
+	 * @param[in] job     index of the job.
+	 * @param[in] context user supplied data.
+	 * @return the generated item.
+	 */
+	void *(*generate)(size_t job, void *context);
+	/**
+	 * Analyses the generated item, runs in the matching pool.
+	 * @param[in] job     index of the job.
+	 * @param[in] item    the generated item.
+	 * @param[in] context user supplied data.
+	 */
+	void (*analyse)(size_t job, void *item, void *context);
+	/**
+	 * Writes and frees the item in the writer thread in the order of completion.
+	 * @param[in] job     index of the job.
+	 * @param[in] item    the analysed item.
+	 * @param[in] context user supplied data.
+	 */
+	void (*write)(size_t job, void *item, void *context);
+	/**
+	 * Emits the ordered output of the job in the writer thread in increasing job order, may be NULL.
+	 * @param[in] job     index of the job.
+	 * @param[in] context user supplied data.
+	 */
+	void (*emit)(size_t job, void *context);
+} Stages;
+
+/**
+ * Runs the jobs through the stages. The generator pool takes the jobs from a scheduler, the stages are
+ * connected by bounded lock-free queues, and the calling thread is the single writer. The memory of a
+ * job is returned to the budget after it was written. If the threads can't be started the jobs run
+ * serially.
+ * @param[in] length   number of the jobs.
+ * @param[in] estimate resource estimates of the jobs.
+ * @param[in] threads  number of the computing threads, with one the jobs run serially in index order.
+ * @param[in] stages   the stages.
+ * @param[in] context  passed to the stages.
+ * @return failure code
+ */
+int runPipeline(size_t length, const JobEstimate *estimate, size_t threads, const Stages *stages, void *context);
+
+#endif /* PIPELINE_H_ */
@@ -0,0 +1,81 @@
+/**	@file   queue.h
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Bounded lock-free multi-producer multi-consumer queue.
+ */
+
+#ifndef QUEUE_H_
+#define QUEUE_H_
+
+#include "util.h"
+
+enum {
+	CACHE_LINE = 64,	///< size of the cache line to keep the ends of the queue apart.
+};
+
+/** One slot of the queue. */
+typedef struct {
+	size_t sequence;	///< turn of the slot, tells whether it is free or filled.
+	size_t job;	///< index of the job.
+	void *item;	///< the passed data.
+} QueueCell;
+
+/** Bounded queue of (job, item) pairs, the positions are claimed with compare-and-swap. */
+typedef struct {
+	QueueCell *cell;	///< the slots.
+	size_t mask;	///< capacity minus one, the capacity is a power of two.
+	char padding[CACHE_LINE];
+	size_t head;	///< position of the next enqueue.
+	char headPadding[CACHE_LINE];
+	size_t tail;	///< position of the next dequeue.
+	char tailPadding[CACHE_LINE];
+} Queue;
+
+/**
+ * Creates the queue.
+ * @param[in] capacity minimal capacity, rounded up to a power of two.
+ * @return the queue
+ */
+Queue *createQueue(size_t capacity);
+
+/**
+ * Frees the queue.
+ * @param[in,out] queue the queue.
+ */
+void destroyQueue(Queue **queue);
+
+/**
+ * Puts the item into the queue if there is free space.
+ * @param[in] queue the queue.
+ * @param[in] job   index of the job.
+ * @param[in] item  the item.
+ * @return false if the queue is full.
+ */
+bool tryEnqueue(Queue *queue, size_t job, void *item);
+
+/**
+ * Takes the oldest item from the queue if there is one.
+ * @param[in]  queue the queue.
+ * @param[out] job   index of the job.
+ * @param[out] item  the item.
+ * @return false if the queue is empty.
+ */
+bool tryDequeue(Queue *queue, size_t *job, void **item);
+
+/**
+ * Puts the item into the queue, backs off while the queue is full.
+ * @param[in] queue the queue.
+ * @param[in] job   index of the job.
+ * @param[in] item  the item.
+ */
+void enqueue(Queue *queue, size_t job, void *item);
+
+/**
+ * Takes the oldest item from the queue, backs off while the queue is empty.
+ * @param[in]  queue the queue.
+ * @param[out] job   index of the job.
+ * @param[out] item  the item.
+ */
+void dequeue(Queue *queue, size_t *job, void **item);
+
+#endif /* QUEUE_H_ */
@@ -0,0 +1,94 @@
+/**	@file   scheduler.h
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Parallel execution of independent jobs.
+ */
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include <pthread.h>
+#include "util.h"
+
+/**
+ * Executes one job.
+ * @param[in] job     index of the job.
+ * @param[in] context user supplied data.
+ */
+typedef void (*JobRunner)(size_t job, void *context);
+
+/**
+ * Returns the number of the online processors.
+ * @return number of the threads to use by default.
+ */
+size_t defaultThreads(void);
+
+/**
+ * Starts the threads, the i-th gets the i-th element of the argument array.
+ * @param[in]  threads  number of the threads.
+ * @param[in]  routine  the thread function.
+ * @param[in]  argument array of the arguments.
+ * @param[in]  size     size of one argument.
+ * @param[out] thread   the started threads.
+ * @return number of the started threads.
+ */
+size_t startThreads(size_t threads, void *(*routine)(void *), void *argument, size_t size, pthread_t thread[]);
+
+/** Resource estimates of the jobs. */
+typedef struct {
+	const double *cost;	///< estimated cost of the jobs.
+	const double *memory;	///< predicted peak memory of the jobs in bytes, NULL if unknown.
+	double memoryLimit;	///< memory budget of the running jobs in bytes, zero means no limit.
+} JobEstimate;
+
+/**
+ * Hands out the jobs longest-first. The jobs are sorted by their estimated cost and dealt to the
+ * per-worker queues in round-robin order. A worker with an empty queue steals the longest waiting job
+ * of the others. With a memory limit a claimed job starts only when its predicted memory fits next to
+ * the running ones, the jobs are admitted in claiming order. A job larger than the limit runs alone.
+ */
+typedef struct Scheduler Scheduler;
+
+/**
+ * Creates the scheduler.
+ * @param[in] length   number of the jobs.
+ * @param[in] estimate resource estimates of the jobs.
+ * @param[in] workers  number of the workers.
+ * @return the scheduler
+ */
+Scheduler *createScheduler(size_t length, const JobEstimate *estimate, size_t workers);
+
+/**
+ * Frees the scheduler.
+ * @param[in,out] scheduler the scheduler.
+ */
+void destroyScheduler(Scheduler **scheduler);
+
+/**
+ * Claims the next job of the worker and waits until it fits into the memory budget.
+ * @param[in]  scheduler the scheduler.
+ * @param[in]  worker    index of the worker.
+ * @param[out] job       index of the job.
+ * @return false if there are no more jobs.
+ */
+bool nextJob(Scheduler *scheduler, size_t worker, size_t *job);
+
+/**
+ * Returns the memory of the finished job to the budget.
+ * @param[in] scheduler the scheduler.
+ * @param[in] job       index of the job.
+ */
+void finishJob(Scheduler *scheduler, size_t job);
+
+/**
+ * Runs the jobs on the given number of threads in the order of the scheduler.
+ * @param[in] length   number of the jobs.
+ * @param[in] estimate resource estimates of the jobs.
+ * @param[in] threads  number of the worker threads, with one the jobs run in index order.
+ * @param[in] run      executes one job.
+ * @param[in] context  passed to the runner.
+ * @return failure code
+ */
+int runJobs(size_t length, const JobEstimate *estimate, size_t threads, JobRunner run, void *context);
+
+#endif /* SCHEDULER_H_ */
@@ -0,0 +1,38 @@
+/**	@file   server.h
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Long-running evaluation of the pairs requested over a socket or the standard input.
+ *
+ *	A request is a line in the CSV layout of pair_input.h, the response is the line
+ *
+ *		name worst typical best period1 period2 relativePeriod length1 length2 relativeLength
+ *
+ *	or "name error reason". The responses of a connection come in the order of its requests, so a
+ *	client may send many requests before reading. The empty lines and the lines starting with '#' are
+ *	skipped, "quit" closes the connection, "shutdown" stops the server after the open connections.
+ *	There are no separate template requests: the program matches pairs, a template matched against a
+ *	target is the pair of the two waves, so it is requested as a pair row with the target first.
+ */
+
+#ifndef SERVER_H_
+#define SERVER_H_
+
+#include "parser_confuse.h"
+
+/** Constants of the server. */
+enum {
+	WAVEFORM_CACHE = 16,	///< number of the generated pairs kept for the repeated requests.
+};
+
+/**
+ * Serves the requests until shut down. Every connection is served by its own thread, which keeps its
+ * FFTW plans and noise spectrum, the generated pairs are shared by the connections.
+ * @param[in] path path of the Unix domain socket, "-" serves the standard input and output. Only a
+ *                 socket is removed from the path, before the binding and after the shutdown.
+ * @param[in] plan the configuration, its band and sampling are the defaults of the requests, the
+ *                 generator of its default wave generates them.
+ * @return failure code
+ */
+int runServer(const char *path, const JobPlan *plan);
+
+#endif /* SERVER_H_ */
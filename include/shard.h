@@ -0,0 +1,51 @@
+/**	@file   shard.h
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Splitting a run into independent shards and merging their outputs.
+ */
+
+#ifndef SHARD_H_
+#define SHARD_H_
+
+#include "util.h"
+
+/** Selects a deterministic subset of the points of a run. */
+typedef struct {
+	size_t index;	///< zero based index of the shard.
+	size_t count;	///< number of the shards, one means no sharding.
+} Shard;
+
+/**
+ * Parses the shard from the "i/N" text.
+ * @param[in]  text  shard description.
+ * @param[out] shard parsed shard.
+ * @return failure code
+ */
+int parseShard(const char *text, Shard *shard);
+
+/**
+ * Decides whether the point belongs to the shard. The points are distributed in round-robin order.
+ * @param[in] shard the shard.
+ * @param[in] index index of the point inside its output file.
+ * @return true if the shard has to evaluate the point.
+ */
+bool isInShard(const Shard *shard, size_t index);
+
+/**
+ * Creates the output directory of the shard inside the output directory of the run.
+ * @param[in,out] outputDir output directory of the run, the shard directory on return.
+ * @param[in]     capacity  size of the outputDir buffer.
+ * @param[in]     shard     the shard.
+ * @return failure code, FAILURE if the shard directory doesn't fit into the buffer.
+ */
+int initShardDirectory(char *outputDir, size_t capacity, const Shard *shard);
+
+/**
+ * Merges the outputs of the shard directories into the output directory. The result has the same
+ * layout as the output of the serial run.
+ * @param[in] outputDir output directory of the run containing the shard directories.
+ * @return failure code
+ */
+int mergeShards(const char *outputDir);
+
+#endif /* SHARD_H_ */
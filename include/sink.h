@@ -0,0 +1,63 @@
+/**	@file   sink.h
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Destinations of the results of the exact pairs.
+ */
+
+#ifndef SINK_H_
+#define SINK_H_
+
+#include "dump.h"
+#include "writer.h"
+
+typedef struct Sink Sink;
+
+/** Destination of the results of the exact pairs, selected by the sink option. */
+struct Sink {
+	/**
+	 * Receives the generated values of an analysed pair in the order of completion, may be NULL.
+	 * @param[in] sink     the sink.
+	 * @param[in] name     name of the pair.
+	 * @param[in] variable the generated values.
+	 * @param[in] pair     parameters of the waves.
+	 * @param[in] analysed results of the analysis.
+	 */
+	void (*dump)(Sink *sink, const char *name, Variable *variable, Wave pair[], Analysed *analysed);
+	/**
+	 * Receives the results of a pair in the order of the pairs, may be NULL.
+	 * @param[in] sink     the sink.
+	 * @param[in] name     name of the pair.
+	 * @param[in] analysed results of the analysis.
+	 */
+	void (*summarise)(Sink *sink, const char *name, Analysed *analysed);
+	/**
+	 * Prints the results of a pair to the standard output in the order of the pairs, may be NULL.
+	 * @param[in] sink     the sink.
+	 * @param[in] name     name of the pair.
+	 * @param[in] analysed results of the analysis.
+	 */
+	void (*report)(Sink *sink, const char *name, Analysed *analysed);
+	const Parameter *parameter;	///< parameters of the run.
+	const char *outputDir;	///< output directory.
+	WriterMode mode;	///< how the files are written.
+	Writer *summary;	///< the summary file, NULL if unused.
+};
+
+/**
+ * Creates the sink selected by the parameters, the full sink dumps every sample of the pairs, the
+ * summary sink writes one row of results per pair to summary.data, both print the results of the pairs
+ * to the standard output, the null sink discards everything.
+ * @param[in] parameter parameters of the run.
+ * @param[in] outputDir output directory.
+ * @param[in] mode      how the files are written.
+ * @return the sink
+ */
+Sink *openSink(const Parameter *parameter, const char *outputDir, WriterMode mode);
+
+/**
+ * Closes the files of the sink and frees it.
+ * @param[in,out] sink the sink.
+ */
+void closeSink(Sink **sink);
+
+#endif /* SINK_H_ */
@@ -0,0 +1,110 @@
+/**	@file   timing.h
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Timing of the stages of the jobs.
+ *
+ *	The durations are collected into logarithmic histograms per stage and per power of two bucket of
+ *	the waveform length, the quantiles are resolved to a quarter of a power of two. When the timing
+ *	is not enabled a measurement costs one predictable branch.
+ */
+
+#ifndef TIMING_H_
+#define TIMING_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include "trace.h"
+#include "util.h"
+
+/** The measured stages. */
+typedef enum {
+	GENERATION_STAGE,	///< generation of a wave by LAL.
+	FILL_STAGE,	///< copying the LAL series into the output.
+	PLAN_STAGE,	///< allocation and planning in initMatch.
+	PSD_STAGE,	///< generation of the noise spectrum.
+	FORWARD_STAGE,	///< the forward FFTs.
+	PRODUCT_STAGE,	///< orthonormalisation and the cross products.
+	INVERSE_STAGE,	///< the inverse FFTs.
+	MATCH_STAGE,	///< search of the matches in the correlations.
+	OUTPUT_STAGE,	///< writing the results of a pair.
+	NUMBER_OF_STAGE,
+} TimingStage;
+
+extern bool timingEnabled;	///< the measurements are recorded.
+
+/**
+ * Returns the name of the stage.
+ * @param[in] stage the stage.
+ * @return the name used in the reports and the traces.
+ */
+const char *getStageName(TimingStage stage);
+
+/**
+ * Reads the monotonic clock.
+ * @return the time in nanoseconds.
+ */
+static inline uint64_t readClock(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec);
+}
+
+/**
+ * Tells whether the stages are measured for the report or the trace.
+ * @return true if the timing or the tracing is enabled.
+ */
+static inline bool isTiming(void) {
+	return (timingEnabled || tracingEnabled);
+}
+
+/**
+ * Starts a measurement.
+ * @return the start time, zero if neither the timing nor the tracing is enabled.
+ */
+static inline uint64_t startTiming(void) {
+	return (isTiming() ? readClock() : 0);
+}
+
+/**
+ * Records the duration, thread safe.
+ * @param[in] stage    the measured stage.
+ * @param[in] length   length of the processed waveform.
+ * @param[in] duration the duration in nanoseconds.
+ */
+void recordDuration(TimingStage stage, size_t length, uint64_t duration);
+
+/**
+ * Records the span since the start into the report and the trace, thread safe.
+ * @param[in] stage  the measured stage.
+ * @param[in] length length of the processed waveform.
+ * @param[in] start  the value of startTiming().
+ * @return the end of the span.
+ */
+uint64_t finishTiming(TimingStage stage, size_t length, uint64_t start);
+
+/**
+ * Ends a measurement started by startTiming().
+ * @param[in] stage  the measured stage.
+ * @param[in] length length of the processed waveform.
+ * @param[in] start  the value of startTiming().
+ */
+static inline void stopTiming(TimingStage stage, size_t length, uint64_t start) {
+	if (isTiming()) {
+		finishTiming(stage, length, start);
+	}
+}
+
+/**
+ * Prints the count, total, median, 95th percentile and maximum of every measured stage and length.
+ * @param[in] file where to print.
+ */
+void printTimingReport(FILE *file);
+
+/**
+ * Writes the same report as a JSON document.
+ * @param[in] file where to write.
+ */
+void writeTimingJSON(FILE *file);
+
+#endif /* TIMING_H_ */
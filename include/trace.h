@@ -0,0 +1,50 @@
+/**	@file   trace.h
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Recording of the stages of the jobs in the Chrome trace format.
+ *
+ *	Every thread records into its own ring buffer, so recording takes no lock and never waits for the
+ *	other threads. A full buffer overwrites its oldest events. The trace can be opened in
+ *	chrome://tracing or in Perfetto.
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <stdint.h>
+#include "util.h"
+
+extern bool tracingEnabled;	///< the spans are recorded.
+
+/**
+ * Names the calling thread in the trace.
+ * @param[in] role  role of the thread.
+ * @param[in] index index of the thread in its pool.
+ */
+void nameTraceThread(const char *role, size_t index);
+
+/**
+ * Tags the following spans of the calling thread with the job.
+ * @param[in] job  index of the job.
+ * @param[in] mass masses of the blackholes of the first wave.
+ */
+void setTraceJob(size_t job, const double mass[2]);
+
+/**
+ * Records a span of the calling thread.
+ * @param[in] name   name of the span, a string literal.
+ * @param[in] begin  start in nanoseconds of the monotonic clock.
+ * @param[in] end    end in nanoseconds of the monotonic clock.
+ * @param[in] length length of the processed waveform.
+ */
+void traceSpan(const char *name, uint64_t begin, uint64_t end, size_t length);
+
+/**
+ * Writes the recorded spans as begin and end events in the Chrome trace JSON format, the threads
+ * must not record meanwhile.
+ * @param[in] path path of the file.
+ * @return failure code
+ */
+int writeTrace(const char *path);
+
+#endif /* TRACE_H_ */
@@ -104,6 +104,30 @@ void setFormat(char formatString[], const ushort number, OutputFormat *format);
 
 void setFormatEnd(char formatString[], const ushort number, OutputFormat *format);
 
+/**	Converts the number exactly as the printf conversion of the format, but without the locale and
+ * the parsing of the format string. The correctly rounded digits are computed directly, only
+ * the numbers too close to a rounding boundary and the too long ones are left to snprintf.
+ * @param[out]	buffer	: the output, terminated with '\0'
+ * @param[in]	size	: size of the output
+ * @param[in]	value	: the number
+ * @param[in]	format	: the format
+ * @return	length of the converted number as snprintf returns it
+ */
+size_t formatDouble(char *buffer, size_t size, double value, const OutputFormat *format);
+
+/**	Format of the numbers of the result rows, the same as "%11.5g" separated by spaces.
+ */
+extern const OutputFormat rowFormat;
+
+/**	Prints the numbers converted by formatDouble, separated by the separator of the format.
+ * @param[in]	file	: where to print
+ * @param[in]	number	: the numbers
+ * @param[in]	count	: number of the numbers
+ * @param[in]	format	: the format
+ * @param[in]	end		: character printed after the last number
+ */
+void printDoubles(FILE *file, const double number[], size_t count, const OutputFormat *format, char end);
+
 ///@}
 #ifdef TEST
 /// @name Test functions
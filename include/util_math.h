@@ -8,6 +8,7 @@
 #ifndef UTIL_MATH_H
 #define UTIL_MATH_H
 
+#include <stdint.h>
 #include "util.h"
 
 typedef enum {
@@ -129,6 +130,71 @@ double randomBetweenZeroAnd(double top);
  */
 double randomBetween(double bottom, double top);
 
+/**	Counter-based random stream, Philox4x32-10. The numbers depend only on the seed, the index of the
+ * stream and the position in the stream, so the streams of the jobs give the same numbers on any
+ * thread and in any order, unlike rand().
+ */
+typedef struct {
+	uint32_t key[2];	///< the seed.
+	uint32_t counter[4];	///< position in the stream and index of the stream.
+	uint32_t block[4];	///< the current output block.
+	unsigned used;	///< number of the used words of the block.
+} RandomStream;
+
+/**	Computes the Philox4x32-10 block of the counter.
+ * @param[in]  key     the key.
+ * @param[in]  counter the counter.
+ * @param[out] block   the random words.
+ */
+void philox(const uint32_t key[2], const uint32_t counter[4], uint32_t block[4]);
+
+/**	Starts the stream of the index.
+ * @param[out] stream	: the stream.
+ * @param[in]  seed		: seed of the run.
+ * @param[in]  index	: index of the stream, e.g. of the job.
+ */
+void initializeRandomStream(RandomStream *stream, uint64_t seed, uint64_t index);
+
+/**  Returns the next number of the stream in the range [0,1) with 53 random bits.
+ * @param[in,out] stream	: the stream.
+ * @return a random number.
+ */
+double randomStreamUniform(RandomStream *stream);
+
+/**  Returns the next number of the stream in the range [bottom,top).
+ * @param[in,out] stream	: the stream.
+ * @param[in]	bottom	: the lowest possible number
+ * @param[in]	top		: the upper limit of the generated numbers.
+ * @return a random number.
+ */
+double randomStreamBetween(RandomStream *stream, double bottom, double top);
+
+///@}
+/// @name Order statistics
+///@{
+
+/**	Compares two doubles for qsort() in increasing order.
+ * @param[in] left	: pointer to the first number.
+ * @param[in] right	: pointer to the second number.
+ * @return negative, zero or positive as the first number is less, equal or greater.
+ */
+int compareDoubles(const void *left, const void *right);
+
+/**	Returns the percentile of the sorted numbers, interpolated linearly between the closest ranks.
+ * @param[in] sorted	: the numbers in increasing order.
+ * @param[in] length	: number of the numbers, at least one.
+ * @param[in] fraction	: the percentile between 0 and 1, e.g. 0.5 for the median.
+ * @return the percentile.
+ */
+double getSortedPercentile(const double sorted[], size_t length, double fraction);
+
+/**	Sorts the numbers and returns their median.
+ * @param[in,out] value	: the numbers, sorted on return.
+ * @param[in]     length	: number of the numbers, at least one.
+ * @return the median.
+ */
+double getMedian(double value[], size_t length);
+
 ///@}
 
 extern const double EPSILON;
@@ -139,6 +205,10 @@ bool isNear(const double first, const double second, const double epsilon);
 
 bool isOK_randomBetween(void);
 
+bool isOK_philox(void);
+
+bool isOK_getSortedPercentile(void);
+
 bool areUtilMathFunctionsOK(void);
 
 #endif	// TEST
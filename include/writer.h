@@ -0,0 +1,105 @@
+/**	@file   writer.h
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Buffered output written by a background thread.
+ */
+
+#ifndef WRITER_H_
+#define WRITER_H_
+
+#include "util.h"
+#include "util_IO.h"
+
+enum {
+	WRITER_BLOCK = 1 << 20,	///< size of one buffer handed to the I/O thread.
+	WRITER_SLACK = 1 << 12,	///< room beyond the block for the last record, the alignment of the direct I/O.
+};
+
+/** How the I/O thread writes the file. */
+typedef enum {
+	WRITER_BUFFERED,	///< through the page cache.
+	WRITER_DIRECT,	///< bypassing the page cache with O_DIRECT, falls back to buffered if unsupported.
+} WriterMode;
+
+typedef struct WriterBlock WriterBlock;
+
+/**
+ * Output file filled by the computing thread. The full buffers are handed to a single background I/O
+ * thread, which writes the consecutive buffers of a file with one writev, so the computing thread only
+ * formats into memory.
+ */
+typedef struct {
+	int descriptor;	///< the file.
+	bool direct;	///< the file is opened with O_DIRECT.
+	WriterBlock *block;	///< the buffer being filled.
+	char *data;	///< data of the current buffer.
+	size_t used;	///< filled bytes of the current buffer.
+	string path;	///< path of the file, for the error messages.
+} Writer;
+
+/**
+ * Opens the file for writing. On error it terminates the program and prints an error message.
+ * @param[in] path path of the file.
+ * @param[in] mode how to write the file.
+ * @return the writer
+ */
+Writer *openWriter(const char *path, WriterMode mode);
+
+/**
+ * Hands the remaining data to the I/O thread, which closes the file and frees the writer.
+ * @param[in,out] writer the writer.
+ */
+void closeWriter(Writer **writer);
+
+/**
+ * Hands the full part of the buffer to the I/O thread and continues in a fresh buffer.
+ * @param[in,out] writer the writer.
+ */
+void passBlock(Writer *writer);
+
+/**
+ * Returns room for at most WRITER_SLACK bytes at the end of the buffer, the used bytes have to be
+ * added to the used field.
+ * @param[in,out] writer the writer.
+ * @return the free room.
+ */
+static inline char *reserveWriter(Writer *writer) {
+	if (writer->used >= WRITER_BLOCK) {
+		passBlock(writer);
+	}
+	return (writer->data + writer->used);
+}
+
+/**
+ * Appends the bytes to the file.
+ * @param[in,out] writer the writer.
+ * @param[in]     data   the bytes.
+ * @param[in]     length number of the bytes.
+ */
+void writeBytes(Writer *writer, const char *data, size_t length);
+
+/**
+ * Appends the formatted text to the file.
+ * @param[in,out] writer the writer.
+ * @param[in]     format the printf format.
+ */
+void writeFormatted(Writer *writer, const char *format, ...) __attribute__ ((format (printf, 2, 3)));
+
+/**
+ * Appends the numbers converted by formatDouble straight into the buffer, separated by the separator
+ * of the format.
+ * @param[in,out] writer the writer.
+ * @param[in]     number the numbers.
+ * @param[in]     count  number of the numbers.
+ * @param[in]     format the format.
+ * @param[in]     end    character appended after the last number.
+ */
+void writeDoubles(Writer *writer, const double number[], size_t count, const OutputFormat *format, char end);
+
+/**
+ * Waits until the I/O thread has written every closed file.
+ * @return failure code, FAILURE if any write failed.
+ */
+int flushWriters(void);
+
+#endif /* WRITER_H_ */
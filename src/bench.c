@@ -0,0 +1,304 @@
+/**	@file   bench.c
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Benchmarks of the generation and the matching.
+ *
+ *	Every case runs a few warm-up repetitions, then the measured ones, and reports the median and the
+ *	median absolute deviation of the wall clock time, which are robust against the occasional
+ *	preemption. The results are printed as whitespace separated columns with a '#' header, or as
+ *	JSON lines with --json, so the runs of two versions can be compared by a script.
+ */
+
+#include <complex.h>
+#include <getopt.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dump.h"
+#include "timing.h"
+
+/** Settings of the benchmark. */
+typedef struct {
+	size_t warmUp;	///< number of the unmeasured repetitions.
+	size_t repetitions;	///< number of the measured repetitions.
+	bool json;	///< prints JSON lines instead of columns.
+	double initialFrequency;	///< initial frequency of the generated waves.
+	double samplingFrequency;	///< sampling frequency of the generated waves.
+	GeneratorKind generator;	///< backend generating the waves.
+} Bench;
+
+/** A case of the benchmark. */
+typedef struct {
+	const char *name;	///< name of the measured code.
+	char setting[STRING_LENGTH];	///< parameters of the case.
+	size_t elements;	///< number of the processed samples or frequency bins.
+	/**
+	 * Runs the measured code once.
+	 * @param[in] context data of the case.
+	 */
+	void (*run)(void *context);
+	void *context;	///< data of the case.
+} BenchCase;
+
+/**
+ * Measures the case and prints its row.
+ * @param[in] bench   settings of the benchmark.
+ * @param[in] current the case.
+ */
+static void measure(const Bench *bench, const BenchCase *current) {
+	for (size_t repetition = 0; repetition < bench->warmUp; repetition++) {
+		current->run(current->context);
+	}
+	double *duration = malloc(bench->repetitions * sizeof(double));
+	for (size_t repetition = 0; repetition < bench->repetitions; repetition++) {
+		uint64_t start = readClock();
+		current->run(current->context);
+		duration[repetition] = (readClock() - start) * 1e-9;
+	}
+	double median = getMedian(duration, bench->repetitions);
+	for (size_t repetition = 0; repetition < bench->repetitions; repetition++) {
+		duration[repetition] = fabs(duration[repetition] - median);
+	}
+	double deviation = getMedian(duration, bench->repetitions);
+	free(duration);
+	double perElement = current->elements ? median / current->elements * 1e9 : 0.0;
+	if (bench->json) {
+		printf("{\"name\":\"%s\",\"setting\":\"%s\",\"elements\":%zu,\"repetitions\":%zu,\"median\":%.9g,"
+		        "\"mad\":%.9g,\"nsPerElement\":%.6g}\n", current->name, current->setting, current->elements,
+		        bench->repetitions, median, deviation, perElement);
+	} else {
+		printf("%-20s %-28s %10zu %6zu %14.6g %14.6g %12.4g\n", current->name, current->setting, current->elements,
+		        bench->repetitions, median, deviation, perElement);
+	}
+	fflush(stdout);
+}
+
+/** Synthetic spectra of a fixed length. */
+typedef struct {
+	size_t length;	///< number of the frequency bins.
+	double _Complex *spectrum[NUMBER_OF_WAVE];	///< the plus and cross spectra.
+	double _Complex *out;	///< the orthonormalised spectrum.
+	double *norm;	///< the noise spectrum.
+	double result;	///< keeps the result alive.
+} Spectra;
+
+static void createSpectra(Spectra *spectra, size_t length) {
+	spectra->length = length;
+	for (int wave = FIRST_WAVE; wave < NUMBER_OF_WAVE; wave++) {
+		spectra->spectrum[wave] = malloc(length * sizeof(double _Complex));
+	}
+	spectra->out = malloc(length * sizeof(double _Complex));
+	spectra->norm = malloc(length * sizeof(double));
+	for (size_t index = 0; index < length; index++) {
+		double phase = 1e-3 * index * index;
+		spectra->spectrum[FIRST_WAVE][index] = cos(phase) + I * sin(phase);
+		spectra->spectrum[SECOND_WAVE][index] = sin(phase) + I * cos(1.1 * phase);
+		spectra->norm[index] = 1.0 + 1e-3 * index;
+	}
+}
+
+static void destroySpectra(Spectra *spectra) {
+	for (int wave = FIRST_WAVE; wave < NUMBER_OF_WAVE; wave++) {
+		free(spectra->spectrum[wave]);
+	}
+	free(spectra->out);
+	free(spectra->norm);
+}
+
+static void runInnerProduct(void *context) {
+	Spectra *spectra = context;
+	spectra->result += innerProduct(spectra->spectrum[FIRST_WAVE], spectra->spectrum[SECOND_WAVE], spectra->norm, 0,
+	        spectra->length);
+}
+
+static void runOrthonormalise(void *context) {
+	Spectra *spectra = context;
+	orthonormalise(spectra->spectrum[FIRST_WAVE], spectra->spectrum[SECOND_WAVE], spectra->norm, 0, spectra->length,
+	        spectra->length, spectra->out);
+}
+
+/** A generated pair with the settings of the run. */
+typedef struct {
+	const Bench *bench;	///< settings of the benchmark.
+	Wave pair[NUMBER_OF_WAVE];	///< parameters of the waves.
+	Variable *variable;	///< the generated values.
+	Analysed analysed;	///< results of the matching.
+} BenchPair;
+
+static void runGeneration(void *context) {
+	BenchPair *pair = context;
+	Wave wave[NUMBER_OF_WAVE];
+	memcpy(wave, pair->pair, sizeof(wave));
+	const Bench *bench = pair->bench;
+	Variable *variable = generateWaveformPair(wave, bench->initialFrequency, 1.0 / bench->samplingFrequency);
+	destroyWaveform(&variable->wave);
+	destroyOutput(&variable);
+}
+
+static void runMatch(void *context) {
+	BenchPair *pair = context;
+	const Bench *bench = pair->bench;
+	size_t minIndex, maxIndex;
+	initMatch(pair->variable->wave);
+	generatePSD(bench->initialFrequency, bench->samplingFrequency);
+	indexFromFrequency(bench->initialFrequency, bench->samplingFrequency / 2.0,
+	        bench->samplingFrequency / pair->variable->size, &minIndex, &maxIndex);
+	calcMatches(minIndex, maxIndex, &pair->analysed);
+	cleanMatch();
+}
+
+static void runCountPeriods(void *context) {
+	BenchPair *pair = context;
+	countPeriods(1.0 / pair->bench->samplingFrequency, &pair->analysed);
+}
+
+static void runTextWriter(void *context) {
+	BenchPair *pair = context;
+	DumpSamples samples;
+	selectSamples(&samples, NULL, pair->variable, 1.0 / pair->bench->samplingFrequency);
+	for (int kind = SPIN_DUMP; kind < NUMBER_OF_DUMP; kind++) {
+		Writer *file = openWriter("/dev/null", WRITER_BUFFERED);
+		printText(file, kind, pair->variable, pair->pair, &pair->analysed, &samples);
+		closeWriter(&file);
+	}
+	releaseSamples(&samples);
+	flushWriters();
+}
+
+/**
+ * Sets the waves of the pair generated by the backend of the benchmark, the second wave differs in the
+ * spin contributions.
+ * @param[out] pair   the pair.
+ * @param[in]  mass   masses of the blackholes.
+ * @param[in]  spin   magnitude of the spins.
+ * @param[in]  tilted the spins are tilted from the orbital angular momentum.
+ */
+static void setPair(BenchPair *pair, const double mass[BH], double spin, bool tilted) {
+	memset(pair->pair, 0, sizeof(pair->pair));
+	for (int wave = FIRST_WAVE; wave < NUMBER_OF_WAVE; wave++) {
+		Wave *current = &pair->pair[wave];
+		for (int blackhole = FIRST; blackhole < BH; blackhole++) {
+			current->binary.mass[blackhole] = mass[blackhole];
+			current->binary.spin.magnitude[blackhole] = spin;
+			current->binary.spin.inclination[blackhole] = tilted ? M_PI / 3.0 : 0.0;
+			current->binary.spin.azimuth[blackhole] = tilted ? M_PI / 4.0 * (blackhole + 1) : 0.0;
+		}
+		current->binary.spin.system = PRECESSING;
+		current->binary.inclination = M_PI / 18.0;
+		current->binary.distance = 1.0;
+		current->method.phase = 4;
+		current->method.amplitude = 0;
+		current->method.generator = pair->bench->generator;
+	}
+	strcpy(pair->pair[FIRST_WAVE].method.spin, "SO");
+	strcpy(pair->pair[SECOND_WAVE].method.spin, "ALL");
+}
+
+static void printUsage(const char *program) {
+	printf("Usage: %s [--warm-up N] [--repetitions N] [--generator lal|chirp] [--json]\n", program);
+	puts("  --warm-up N      number of the unmeasured repetitions, 2 by default.");
+	puts("  --repetitions N  number of the measured repetitions, 11 by default.");
+	puts("  --generator NAME backend generating the pairs, lal by default; chirp measures the matching");
+	puts("                   without the cost of LALSimulation.");
+	puts("  --json           prints one JSON object per case instead of columns.");
+}
+
+static int parseArguments(int argc, char *argv[], Bench *bench) {
+	static struct option options[] = { //
+	        { "warm-up", required_argument, NULL, 'w' }, //
+	        { "repetitions", required_argument, NULL, 'r' }, //
+	        { "generator", required_argument, NULL, 'g' }, //
+	        { "json", no_argument, NULL, 'j' }, //
+	        { "help", no_argument, NULL, 'h' }, //
+	        { NULL, 0, NULL, 0 } };
+	*bench = (Bench ) { 2, 11, false, 40.0, 4096.0, LAL_GENERATOR };
+	int option;
+	while ((option = getopt_long(argc, argv, "h", options, NULL)) != -1) {
+		switch (option) {
+		case 'w':
+			bench->warmUp = strtoul(optarg, NULL, 10);
+			break;
+		case 'r':
+			bench->repetitions = strtoul(optarg, NULL, 10);
+			bench->repetitions = bench->repetitions ? bench->repetitions : 1;
+			break;
+		case 'g':
+			if (findGenerator(optarg, &bench->generator)) {
+				fprintf(stderr, "Unknown generator \"%s\", use \"lal\" or \"chirp\".\n", optarg);
+				return (FAILURE);
+			}
+			break;
+		case 'j':
+			bench->json = true;
+			break;
+		case 'h':
+		default:
+			printUsage(argv[0]);
+			return (FAILURE);
+		}
+	}
+	return (SUCCESS);
+}
+
+/**
+ * Runs the benchmark matrix: the spectral kernels over fixed lengths, then the generation and the
+ * processing of the generated pairs over fixed masses and spins.
+ * @param[in] argc number of arguments
+ * @param[in] argv arguments
+ * @return	error code
+ */
+int main(int argc, char *argv[]) {
+	Bench bench;
+	if (parseArguments(argc, argv, &bench)) {
+		return (EXIT_FAILURE);
+	}
+	if (!bench.json) {
+		printf("#%-19s %-28s %10s %6s %14s %14s %12s\n", "name", "setting", "elements", "reps", "median[s]",
+		        "mad[s]", "ns/element");
+	}
+	static const size_t length[] = { 1 << 12, 1 << 14, 1 << 16, 1 << 18, 1 << 20 };
+	for (size_t current = 0; current < sizeof(length) / sizeof(length[0]); current++) {
+		Spectra spectra;
+		createSpectra(&spectra, length[current]);
+		BenchCase kernel = { "innerProduct", "", length[current], runInnerProduct, &spectra };
+		sprintf(kernel.setting, "length=%zu", length[current]);
+		measure(&bench, &kernel);
+		kernel.name = "orthonormalise";
+		kernel.run = runOrthonormalise;
+		measure(&bench, &kernel);
+		destroySpectra(&spectra);
+	}
+	static const double mass[][BH] = { { 30.0, 30.0 }, { 10.0, 10.0 }, { 3.0, 30.0 } };
+	static const struct {
+		const char *name;
+		double magnitude;
+		bool tilted;
+	} spin[] = { { "nonspinning", 0.0, false }, { "aligned", 0.7, false }, { "precessing", 0.7, true } };
+	for (size_t masses = 0; masses < sizeof(mass) / sizeof(mass[0]); masses++) {
+		for (size_t spins = 0; spins < sizeof(spin) / sizeof(spin[0]); spins++) {
+			BenchPair pair = { .bench = &bench };
+			setPair(&pair, mass[masses], spin[spins].magnitude, spin[spins].tilted);
+			Wave wave[NUMBER_OF_WAVE];
+			memcpy(wave, pair.pair, sizeof(wave));
+			pair.variable = generateWaveformPair(wave, bench.initialFrequency, 1.0 / bench.samplingFrequency);
+			BenchCase process = { "generateWaveformPair", "", pair.variable->size, runGeneration, &pair };
+			sprintf(process.setting, "%s m=%g,%g %s", getGeneratorName(bench.generator), mass[masses][FIRST],
+			        mass[masses][SECOND], spin[spins].name);
+			measure(&bench, &process);
+			process.name = "calcMatches";
+			process.run = runMatch;
+			measure(&bench, &process);
+			initMatch(pair.variable->wave);
+			process.name = "countPeriods";
+			process.run = runCountPeriods;
+			measure(&bench, &process);
+			cleanMatch();
+			process.name = "printText";
+			process.run = runTextWriter;
+			measure(&bench, &process);
+			destroyWaveform(&pair.variable->wave);
+			destroyOutput(&pair.variable);
+		}
+	}
+	return (EXIT_SUCCESS);
+}
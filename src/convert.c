@@ -0,0 +1,76 @@
+/**	@file   convert.c
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Converts the binary dumps to the text layout and the CSV pair files to the binary one.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "dump.h"
+#include "pair_input.h"
+
+/**
+ * Converts one binary dump to a text dump next to it, the ".bin" extension is replaced by ".data".
+ * @param[in] path path of the binary dump.
+ * @return failure code
+ */
+static int convert(const char *path) {
+	DumpFile *dump = openDump(path);
+	if (!dump) {
+		return (FAILURE);
+	}
+	char output[FILENAME_MAX];
+	size_t length = strlen(path);
+	const char *extension = length > 4 && !strcmp(path + length - 4, ".bin") ? path + length - 4 : path + length;
+	snprintf(output, sizeof(output), "%.*s.%s", (int) (extension - path), path, getDumpExtension(TEXT_FORMAT));
+	Variable variable;
+	Waveform waveform;
+	Wave wave[NUMBER_OF_WAVE];
+	Analysed analysed;
+	viewDump(dump, &variable, &waveform, wave, &analysed);
+	DumpSamples samples;
+	selectSamples(&samples, NULL, &variable, dump->header->timeStep);
+	samples.startTime = dump->header->startTime;
+	Writer *file = openWriter(output, WRITER_BUFFERED);
+	printText(file, dump->header->kind, &variable, wave, &analysed, &samples);
+	closeWriter(&file);
+	int failure = flushWriters();
+	closeDump(&dump);
+	return (failure);
+}
+
+/**
+ * Converts a CSV pair file to a binary pair file next to it, the ".csv" extension is replaced by ".pairs".
+ * @param[in] path path of the CSV pair file.
+ * @return failure code
+ */
+static int convertPairFile(const char *path) {
+	char output[FILENAME_MAX];
+	snprintf(output, sizeof(output), "%.*s.pairs", (int) (strlen(path) - 4), path);
+	return (convertPairs(path, output));
+}
+
+static bool isPairFile(const char *path) {
+	size_t length = strlen(path);
+	return (length > 4 && !strcmp(path + length - 4, ".csv"));
+}
+
+/**
+ * Main program function.
+ * @param[in] argc number of arguments
+ * @param[in] argv binary dumps or CSV pair files to convert
+ * @return	error code
+ */
+int main(int argc, char *argv[]) {
+	if (argc < 2) {
+		printf("Usage: %s dump.bin|pairs.csv...\n", argv[0]);
+		puts("  Writes the text layout of each binary dump next to it with the .data extension,");
+		puts("  and the binary layout of each CSV pair file next to it with the .pairs extension.");
+		return (EXIT_FAILURE);
+	}
+	int failure = SUCCESS;
+	for (int current = 1; current < argc; current++) {
+		failure |= isPairFile(argv[current]) ? convertPairFile(argv[current]) : convert(argv[current]);
+	}
+	return (failure ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -0,0 +1,157 @@
+/**	@file   counters.c
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Hardware performance counters around the matching kernels.
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include "counters.h"
+
+/** Measurements of a kernel. */
+typedef struct {
+	uint64_t calls;	///< number of the measured calls.
+	uint64_t elements;	///< number of the processed elements.
+	uint64_t value[NUMBER_OF_COUNTER];	///< the counted events.
+} KernelCounters;
+
+/** Counter group of a thread. */
+typedef struct {
+	bool opened;	///< the opening was attempted.
+	int descriptor[NUMBER_OF_COUNTER];	///< the counters, negative if unavailable, the first leads the group.
+	int slot[NUMBER_OF_COUNTER];	///< position of the counter in the group read, negative if unavailable.
+	int members;	///< number of the opened counters.
+} CounterGroup;
+
+bool countersEnabled = false;
+
+static KernelCounters kernels[NUMBER_OF_KERNEL];	///< updated atomically by the workers.
+static bool available[NUMBER_OF_COUNTER];	///< the counter could be opened by any thread.
+static __thread CounterGroup group;	///< counters of the calling thread.
+static pthread_once_t once = PTHREAD_ONCE_INIT;	///< creates the key.
+static pthread_key_t key;	///< closes the counters of the exiting threads.
+
+static const char *kernelName[NUMBER_OF_KERNEL] = { "innerProduct", "crossProduct", "matches" };
+static const char *counterName[NUMBER_OF_COUNTER] = { "cycles", "instructions", "cacheMisses", "branchMisses" };
+static const uint64_t counterConfig[NUMBER_OF_COUNTER] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+	PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES };
+
+static int openCounter(Counter counter, int leader) {
+	struct perf_event_attr attribute;
+	memset(&attribute, 0, sizeof(attribute));
+	attribute.size = sizeof(attribute);
+	attribute.type = PERF_TYPE_HARDWARE;
+	attribute.config = counterConfig[counter];
+	attribute.disabled = leader < 0;
+	attribute.exclude_kernel = 1;
+	attribute.exclude_hv = 1;
+	attribute.read_format = PERF_FORMAT_GROUP;
+	return ((int) syscall(SYS_perf_event_open, &attribute, 0, -1, leader, 0));
+}
+
+static void closeGroup(void *argument) {
+	CounterGroup *closed = argument;
+	for (int counter = CYCLES_COUNTER; counter < NUMBER_OF_COUNTER; counter++) {
+		if (closed->descriptor[counter] >= 0) {
+			close(closed->descriptor[counter]);
+		}
+	}
+}
+
+static void createKey(void) {
+	pthread_key_create(&key, closeGroup);
+}
+
+/**
+ * Opens the counter group of the calling thread. If the leader can't be opened, the counting is
+ * switched off for every thread.
+ */
+static void openGroup(void) {
+	group.opened = true;
+	group.members = 0;
+	int leader = openCounter(CYCLES_COUNTER, -1);
+	if (leader < 0) {
+		if (__atomic_exchange_n(&countersEnabled, false, __ATOMIC_RELAXED)) {
+			fprintf(stderr, "Hardware counters are unavailable, counting is switched off; %s\n", strerror(errno));
+		}
+		for (int counter = CYCLES_COUNTER; counter < NUMBER_OF_COUNTER; counter++) {
+			group.descriptor[counter] = group.slot[counter] = -1;
+		}
+		return;
+	}
+	for (int counter = CYCLES_COUNTER; counter < NUMBER_OF_COUNTER; counter++) {
+		group.descriptor[counter] = counter == CYCLES_COUNTER ? leader : openCounter(counter, leader);
+		group.slot[counter] = group.descriptor[counter] < 0 ? -1 : group.members++;
+		if (group.slot[counter] >= 0) {
+			__atomic_store_n(&available[counter], true, __ATOMIC_RELAXED);
+		}
+	}
+	pthread_once(&once, createKey);
+	pthread_setspecific(key, &group);
+	ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+	ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+void readCounters(CounterValues *values) {
+	memset(values, 0, sizeof(CounterValues));
+	if (!group.opened) {
+		openGroup();
+	}
+	uint64_t buffer[1 + NUMBER_OF_COUNTER];
+	if (group.descriptor[CYCLES_COUNTER] < 0
+	        || read(group.descriptor[CYCLES_COUNTER], buffer, sizeof(buffer)) < (ssize_t) sizeof(uint64_t)) {
+		return;
+	}
+	for (int counter = CYCLES_COUNTER; counter < NUMBER_OF_COUNTER; counter++) {
+		if (group.slot[counter] >= 0 && (uint64_t) group.slot[counter] < buffer[0]) {
+			values->value[counter] = buffer[1 + group.slot[counter]];
+		}
+	}
+}
+
+void recordCounters(Kernel kernel, size_t elements, const CounterValues *start) {
+	CounterValues end;
+	readCounters(&end);
+	KernelCounters *current = &kernels[kernel];
+	__atomic_fetch_add(&current->calls, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&current->elements, elements, __ATOMIC_RELAXED);
+	for (int counter = CYCLES_COUNTER; counter < NUMBER_OF_COUNTER; counter++) {
+		__atomic_fetch_add(&current->value[counter], end.value[counter] - start->value[counter], __ATOMIC_RELAXED);
+	}
+}
+
+void printCounterReport(FILE *file) {
+	fprintf(file, "#%-13s %10s %14s", "kernel", "calls", "elements");
+	for (int counter = CYCLES_COUNTER; counter < NUMBER_OF_COUNTER; counter++) {
+		fprintf(file, " %14s", counterName[counter]);
+	}
+	fprintf(file, " %8s\n", "IPC");
+	for (int kernel = INNER_PRODUCT_KERNEL; kernel < NUMBER_OF_KERNEL; kernel++) {
+		KernelCounters *current = &kernels[kernel];
+		if (!current->calls) {
+			continue;
+		}
+		fprintf(file, "%-14s %10llu %14llu", kernelName[kernel], (unsigned long long) current->calls,
+		        (unsigned long long) current->elements);
+		double elements = current->elements ? (double) current->elements : 1.0;
+		for (int counter = CYCLES_COUNTER; counter < NUMBER_OF_COUNTER; counter++) {
+			if (available[counter]) {
+				fprintf(file, " %14.6g", current->value[counter] / elements);
+			} else {
+				fprintf(file, " %14s", "n/a");
+			}
+		}
+		if (available[CYCLES_COUNTER] && available[INSTRUCTIONS_COUNTER] && current->value[CYCLES_COUNTER]) {
+			fprintf(file, " %8.3f\n", (double) current->value[INSTRUCTIONS_COUNTER] / current->value[CYCLES_COUNTER]);
+		} else {
+			fprintf(file, " %8s\n", "n/a");
+		}
+	}
+	fputs("#the counters are events per frequency bin or sample.\n", file);
+}
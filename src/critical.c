@@ -0,0 +1,81 @@
+/**	@file   critical.c
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Search of the spin magnitude where the match of the pair crosses a threshold.
+ */
+
+#include <math.h>
+#include <string.h>
+#include "critical.h"
+
+/**
+ * Evaluates the pair with the magnitude of the blackhole set for both waves.
+ * @param[in,out] engine    the engine.
+ * @param[in,out] pair      the pair, its magnitude is overwritten.
+ * @param[in]     blackhole index of the blackhole.
+ * @param[in]     magnitude the magnitude.
+ * @param[in]     threshold the match to cross.
+ * @param[out]    distance  the worst match minus the threshold.
+ * @param[in,out] result    counts the evaluation.
+ * @return failure code
+ */
+static int evaluate(Engine *engine, Wave pair[], int blackhole, double magnitude, double threshold,
+        double *distance, CriticalSpin *result) {
+	for (int wave = FIRST_WAVE; wave < NUMBER_OF_WAVE; wave++) {
+		pair[wave].binary.spin.magnitude[blackhole] = magnitude;
+	}
+	Analysed analysed;
+	result->evaluations++;
+	int failure = matchWithEngine(engine, pair, &analysed);
+	*distance = analysed.match[WORST] - threshold;
+	return (failure);
+}
+
+int findCriticalSpin(Engine *engine, const Wave pair[], int blackhole, double threshold, double tolerance,
+        CriticalSpin *result) {
+	Wave current[NUMBER_OF_WAVE];
+	memcpy(current, pair, sizeof(current));
+	memset(result, 0, sizeof(CriticalSpin));
+	result->magnitude = NAN;
+	double low = pair[FIRST_WAVE].binary.spin.magnitude[blackhole];
+	double high = 1.0;
+	if (low >= high) {
+		low = 0.0;
+	}
+	double atLow, atHigh;
+	if (evaluate(engine, current, blackhole, low, threshold, &atLow, result)
+	        || evaluate(engine, current, blackhole, high, threshold, &atHigh, result)) {
+		return (FAILURE);
+	}
+	result->match[MIN] = atLow + threshold;
+	result->match[MAX] = atHigh + threshold;
+	result->bracket[MIN] = low;
+	result->bracket[MAX] = high;
+	if (atLow == 0.0 || atHigh == 0.0) {
+		result->magnitude = atLow == 0.0 ? low : high;
+		return (SUCCESS);
+	}
+	if ((atLow < 0.0) == (atHigh < 0.0)) {
+		return (SUCCESS);
+	}
+	while (high - low > tolerance) {
+		double middle = 0.5 * (low + high);
+		if (middle <= low || middle >= high) {
+			break;
+		}
+		double atMiddle;
+		if (evaluate(engine, current, blackhole, middle, threshold, &atMiddle, result)) {
+			return (FAILURE);
+		}
+		if ((atMiddle < 0.0) == (atLow < 0.0)) {
+			low = middle;
+			atLow = atMiddle;
+		} else {
+			high = middle;
+		}
+	}
+	result->bracket[MIN] = low;
+	result->bracket[MAX] = high;
+	result->magnitude = 0.5 * (low + high);
+	return (SUCCESS);
+}
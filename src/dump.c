@@ -0,0 +1,395 @@
+/**	@file   dump.c
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Dumps of the generated waveforms.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dump.h"
+#include "util_IO.h"
+
+static void printHeader(Writer *file, Wave parameter[2], Analysed *analysed) {
+	double M[NUMBER_OF_WAVE] = {
+	    parameter[FIRST_WAVE].binary.mass[0] + parameter[FIRST_WAVE].binary.mass[1],
+	    parameter[SECOND_WAVE].binary.mass[0] + parameter[SECOND_WAVE].binary.mass[1] };
+	double eta[NUMBER_OF_WAVE] = { parameter[FIRST_WAVE].binary.mass[0] * parameter[FIRST_WAVE].binary.mass[1]
+	        / square(M[FIRST_WAVE]), parameter[SECOND_WAVE].binary.mass[0] * parameter[SECOND_WAVE].binary.mass[1]
+	        / square(M[SECOND_WAVE]) };
+	for (int wave = FIRST_WAVE; wave < NUMBER_OF_WAVE; wave++) {
+		writeFormatted(file, "#%d mass  [m1,m2,M,eta] %11.5g %11.5g %11.5g %11.5g\n", wave,
+		        parameter[wave].binary.mass[0], parameter[wave].binary.mass[1], M[wave], eta[wave]);
+	}
+	for (int blackhole = 0; blackhole < BH; blackhole++) {
+		for (int wave = FIRST_WAVE; wave < NUMBER_OF_WAVE; wave++) {
+			writeFormatted(file, "#%d spin%d [mag,inc,azi] %11.5g %11.5g %11.5g\n", wave, blackhole,
+			        parameter[wave].binary.spin.magnitude[blackhole],
+			        degreeFromRadian(parameter[wave].binary.spin.inclination[blackhole]),
+			        degreeFromRadian(parameter[wave].binary.spin.azimuth[blackhole]));
+		}
+	}
+	for (int wave = FIRST_WAVE; wave < NUMBER_OF_WAVE; wave++) {
+		writeFormatted(file, "#%d method[int, pn,amp] %11s %11d %11d\n", wave, parameter[wave].method.spin,
+		        parameter[wave].method.phase, parameter[wave].method.amplitude);
+	}
+	writeFormatted(file, "#  match [typ,max,min] %11.5g %11.5g %11.5g\n", analysed->match[TYPICAL],
+	        analysed->match[BEST], analysed->match[WORST]);
+	writeFormatted(file, "#  period[ 1., 2.,rel] %11zu %11zu %11.5g\n", analysed->period[FIRST_WAVE],
+	        analysed->period[SECOND_WAVE], analysed->relativePeriod);
+	writeFormatted(file, "#  length[ 1., 2.,rel] %11.5g %11.5g %11.5g\n", analysed->length[FIRST_WAVE],
+	        analysed->length[SECOND_WAVE], analysed->relativeLength);
+}
+
+/** Format of the numbers of the dumps, the same as "% 11.5g". */
+static const OutputFormat dumpFormat = { 5, 11, 11 + SEPARATOR_LENGTH, 'g', ' ', false, "% 11.5lg", "%11s" };
+
+/**
+ * Prints a row of numbers separated by spaces into the buffer of the writer.
+ * @param[in] file   where to print.
+ * @param[in] number the numbers.
+ * @param[in] count  number of the numbers.
+ */
+static void printRow(Writer *file, const double number[], size_t count) {
+	writeDoubles(file, number, count, &dumpFormat, '\n');
+}
+
+/** Number of the columns of the dumps. */
+enum {
+	COLUMNS = 1 + 4 * DIMENSION,
+	FILTER_ZEROS = 4,	///< number of the zero crossings of the anti-aliasing filter on each side.
+};
+
+void selectSamples(DumpSamples *samples, const DumpOption *option, const Variable *variable, double samplingTime) {
+	memset(samples, 0, sizeof(DumpSamples));
+	int shorter = variable->length[FIRST_WAVE] < variable->length[SECOND_WAVE] ? FIRST_WAVE : SECOND_WAVE;
+	samples->length = variable->length[shorter];
+	samples->samplingTime = samplingTime;
+	samples->stride = 1;
+	size_t end = samples->length;
+	if (option) {
+		samples->stride = option->stride > 1 ? option->stride : 1;
+		if (option->window[MIN] > 0.0) {
+			samples->first = (size_t) ceil(option->window[MIN] / samplingTime);
+		}
+		if (option->window[MAX] > option->window[MIN]) {
+			size_t last = (size_t) floor(option->window[MAX] / samplingTime) + 1;
+			end = last < end ? last : end;
+		}
+		if (option->last > 0.0) {
+			size_t last = (size_t) ceil(option->last / samplingTime);
+			if (last < samples->length && samples->first < samples->length - last) {
+				samples->first = samples->length - last;
+			}
+		}
+	}
+	if (samples->first < end) {
+		samples->count = (end - samples->first + samples->stride - 1) / samples->stride;
+	}
+	if (option && option->antiAlias && samples->stride > 1) {
+		samples->halfWidth = FILTER_ZEROS * samples->stride;
+		samples->taps = malloc((2 * samples->halfWidth + 1) * sizeof(double));
+		double sum = 0.0;
+		for (size_t tap = 0; tap <= 2 * samples->halfWidth; tap++) {
+			double distance = (double) tap - (double) samples->halfWidth;
+			double phase = M_PI * distance / samples->stride;
+			double window = M_PI * distance / samples->halfWidth;
+			double blackman = 0.42 + 0.5 * cos(window) + 0.08 * cos(2.0 * window);
+			samples->taps[tap] = (distance ? sin(phase) / phase : 1.0) * blackman;
+			sum += samples->taps[tap];
+		}
+		for (size_t tap = 0; tap <= 2 * samples->halfWidth; tap++) {
+			samples->taps[tap] /= sum;
+		}
+	}
+}
+
+void releaseSamples(DumpSamples *samples) {
+	free(samples->taps);
+	samples->taps = NULL;
+}
+
+/**
+ * Returns the value of the column at the sample, the waveforms are low-pass filtered if the samples
+ * are anti-aliased, the filter is renormalised at the ends of the wave.
+ * @param[in] column  the column.
+ * @param[in] index   index of the sample.
+ * @param[in] samples the selected samples.
+ * @param[in] smooth  the column is a waveform.
+ * @return the value.
+ */
+static double sampleValue(const double *column, size_t index, const DumpSamples *samples, bool smooth) {
+	if (!smooth || !samples->taps) {
+		return (column[index]);
+	}
+	size_t from = index > samples->halfWidth ? index - samples->halfWidth : 0;
+	size_t to = index + samples->halfWidth < samples->length ? index + samples->halfWidth : samples->length - 1;
+	double value = 0.0, weight = 0.0;
+	for (size_t current = from; current <= to; current++) {
+		double tap = samples->taps[current + samples->halfWidth - index];
+		value += tap * column[current];
+		weight += tap;
+	}
+	return (value / weight);
+}
+
+/**
+ * Returns the index of the dumped sample.
+ * @param[in] samples the selected samples.
+ * @param[in] row     index of the row in the dump.
+ * @return index of the sample.
+ */
+static size_t sampleIndex(const DumpSamples *samples, size_t row) {
+	return (samples->first + row * samples->stride);
+}
+
+/**
+ * Returns the time of the row, computed as the readers of the binary dumps do.
+ * @param[in] samples the selected samples.
+ * @param[in] row     index of the row in the dump.
+ * @return the time.
+ */
+static double sampleTime(const DumpSamples *samples, size_t row) {
+	double startTime = samples->startTime + samples->first * samples->samplingTime;
+	return (startTime + row * (samples->stride * samples->samplingTime));
+}
+
+/**
+ * Prints the time and four vectors of the two waves for the selected samples.
+ * @param[in] file     where to print.
+ * @param[in] vector   the vectors of the waves.
+ * @param[in] samples  the selected samples.
+ */
+static void printVectors(Writer *file, double **vector[4], const DumpSamples *samples) {
+	double row[COLUMNS];
+	for (size_t current = 0; current < samples->count; current++) {
+		size_t index = sampleIndex(samples, current);
+		row[0] = sampleTime(samples, current);
+		for (int vectors = 0; vectors < 4; vectors++) {
+			for (int dimension = X; dimension < DIMENSION; dimension++) {
+				row[1 + DIMENSION * vectors + dimension] = vector[vectors][dimension][index];
+			}
+		}
+		printRow(file, row, COLUMNS);
+	}
+}
+
+void printSpins(Writer *file, Variable variable[2], Wave *wave, Analysed *analysed, const DumpSamples *samples) {
+	printHeader(file, wave, analysed);
+	writeFormatted(file, "#%10.5s ", "t");
+	writeFormatted(file, "%11.5s %11.5s %11.5s ", "1s1x", "1s1y", "1s1z");
+	writeFormatted(file, "%11.5s %11.5s %11.5s ", "2s1x", "2s1y", "2s1z");
+	writeFormatted(file, "%11.5s %11.5s %11.5s ", "1s2x", "1s2y", "1s2z");
+	writeFormatted(file, "%11.5s %11.5s %11.5s\n", "2s2x", "2s2y", "2s2z");
+	double **vector[4] = { variable->S1[FIRST_WAVE], variable->S1[SECOND_WAVE], variable->S2[FIRST_WAVE],
+		variable->S2[SECOND_WAVE] };
+	printVectors(file, vector, samples);
+}
+
+void printSystem(Writer *file, Variable variable[2], Wave *wave, Analysed *analysed, const DumpSamples *samples) {
+	printHeader(file, wave, analysed);
+	writeFormatted(file, "#%10.5s ", "t");
+	writeFormatted(file, "%11.5s %11.5s %11.5s ", "1e1x", "1e1y", "1e1z");
+	writeFormatted(file, "%11.5s %11.5s %11.5s ", "2e1x", "2e1y", "2e1z");
+	writeFormatted(file, "%11.5s %11.5s %11.5s ", "1e3x", "1e3y", "1e3z");
+	writeFormatted(file, "%11.5s %11.5s %11.5s\n", "2e3x", "2e3y", "2e3z");
+	double **vector[4] = { variable->E1[FIRST_WAVE], variable->E1[SECOND_WAVE], variable->E3[FIRST_WAVE],
+		variable->E3[SECOND_WAVE] };
+	printVectors(file, vector, samples);
+}
+
+int printOutput(Writer *file, Variable variable[2], Wave *wave, Analysed *analysed, const DumpSamples *samples) {
+	printHeader(file, wave, analysed);
+	writeFormatted(file, "#%10s %11s %11s %11s %11s %11s %11s %11s %11s %11s %11s %11s %11s\n", "t", "h1", "h2", "hp1",
+	        "hc1", "hp2", "hc2", "omega1", "omega2", "phi1", "phi2", "phi1(deg)", "phi2(deg)");
+	Waveform *h = variable->wave;
+	for (size_t current = 0; current < samples->count; current++) {
+		size_t index = sampleIndex(samples, current);
+		double row[COLUMNS] = { sampleTime(samples, current),
+			sampleValue(h->H[FIRST_WAVE], index, samples, true), sampleValue(h->H[SECOND_WAVE], index, samples, true),
+			sampleValue(h->h[HP1], index, samples, true), sampleValue(h->h[HC1], index, samples, true),
+			sampleValue(h->h[HP2], index, samples, true), sampleValue(h->h[HC2], index, samples, true),
+			variable->V[FIRST_WAVE][index], variable->V[SECOND_WAVE][index], variable->Phi[FIRST_WAVE][index],
+			variable->Phi[SECOND_WAVE][index], degreeFromRadian(normaliseRadians(variable->Phi[FIRST_WAVE][index])),
+			degreeFromRadian(normaliseRadians(variable->Phi[SECOND_WAVE][index])) };
+		printRow(file, row, COLUMNS);
+	}
+	return (SUCCESS);
+}
+
+void printText(Writer *file, DumpKind kind, Variable *variable, Wave *wave, Analysed *analysed,
+        const DumpSamples *samples) {
+	switch (kind) {
+	case SPIN_DUMP:
+		printSpins(file, variable, wave, analysed, samples);
+		break;
+	case SYSTEM_DUMP:
+		printSystem(file, variable, wave, analysed, samples);
+		break;
+	case WAVE_DUMP:
+		printOutput(file, variable, wave, analysed, samples);
+		break;
+	default:
+		break;
+	}
+}
+
+/** Names of the binary columns. */
+static const char columnName[NUMBER_OF_DUMP][DUMP_COLUMNS][DUMP_NAME] = { //
+        { "1s1x", "1s1y", "1s1z", "2s1x", "2s1y", "2s1z", "1s2x", "1s2y", "1s2z", "2s2x", "2s2y", "2s2z" }, //
+        { "1e1x", "1e1y", "1e1z", "2e1x", "2e1y", "2e1z", "1e3x", "1e3y", "1e3z", "2e3x", "2e3y", "2e3z" }, //
+        { "h1", "h2", "hp1", "hc1", "hp2", "hc2", "omega1", "omega2", "phi1", "phi2" } };
+
+/** Number of the binary columns, the time and the phases in degrees are computed by the readers. */
+static const uint32_t columns[NUMBER_OF_DUMP] = { 4 * DIMENSION, 4 * DIMENSION, COMPONENT + 3 * NUMBER_OF_WAVE };
+
+/**
+ * Locates the binary columns among the generated values.
+ * @param[in]  kind     contents of the dump.
+ * @param[in]  variable the generated values.
+ * @param[out] column   places of the columns.
+ */
+static void locateColumns(DumpKind kind, Variable *variable, double **column[DUMP_COLUMNS]) {
+	double *(*vector[4])[DIMENSION] = { variable->S1, variable->S1, variable->S2, variable->S2 };
+	if (kind == SYSTEM_DUMP) {
+		vector[0] = vector[1] = variable->E1;
+		vector[2] = vector[3] = variable->E3;
+	}
+	switch (kind) {
+	case SPIN_DUMP:
+	case SYSTEM_DUMP:
+		for (int current = 0; current < 4; current++) {
+			for (int dimension = X; dimension < DIMENSION; dimension++) {
+				column[DIMENSION * current + dimension] = &vector[current][current % NUMBER_OF_WAVE][dimension];
+			}
+		}
+		break;
+	case WAVE_DUMP:
+		column[0] = &variable->wave->H[FIRST_WAVE];
+		column[1] = &variable->wave->H[SECOND_WAVE];
+		for (int component = HP1; component < COMPONENT; component++) {
+			column[NUMBER_OF_WAVE + component] = &variable->wave->h[component];
+		}
+		for (int wave = FIRST_WAVE; wave < NUMBER_OF_WAVE; wave++) {
+			column[NUMBER_OF_WAVE + COMPONENT + wave] = &variable->V[wave];
+			column[2 * NUMBER_OF_WAVE + COMPONENT + wave] = &variable->Phi[wave];
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+static void fillHeader(DumpHeader *header, Wave *wave, Analysed *analysed) {
+	for (int current = FIRST_WAVE; current < NUMBER_OF_WAVE; current++) {
+		DumpWave *dumped = &header->wave[current];
+		for (int blackhole = FIRST; blackhole < BH; blackhole++) {
+			dumped->mass[blackhole] = wave[current].binary.mass[blackhole];
+			dumped->magnitude[blackhole] = wave[current].binary.spin.magnitude[blackhole];
+			dumped->inclination[blackhole] = wave[current].binary.spin.inclination[blackhole];
+			dumped->azimuth[blackhole] = wave[current].binary.spin.azimuth[blackhole];
+		}
+		strncpy(dumped->spin, wave[current].method.spin, DUMP_TEXT - 1);
+		dumped->phase = wave[current].method.phase;
+		dumped->amplitude = wave[current].method.amplitude;
+		header->analysed.period[current] = analysed->period[current];
+		header->analysed.length[current] = analysed->length[current];
+	}
+	memcpy(header->analysed.match, analysed->match, sizeof(header->analysed.match));
+	header->analysed.relativePeriod = analysed->relativePeriod;
+	header->analysed.relativeLength = analysed->relativeLength;
+}
+
+/**
+ * Tells whether the column is a waveform, which is filtered before the decimation.
+ * @param[in] kind   contents of the dump.
+ * @param[in] column index of the column.
+ * @return true for the waveforms.
+ */
+static bool isWaveform(DumpKind kind, size_t column) {
+	return (kind == WAVE_DUMP && column < NUMBER_OF_WAVE + COMPONENT);
+}
+
+/**
+ * Writes the selected samples of the column.
+ * @param[in] file    where to print.
+ * @param[in] column  the column.
+ * @param[in] samples the selected samples.
+ * @param[in] smooth  the column is a waveform.
+ */
+static void writeColumn(Writer *file, const double *column, const DumpSamples *samples, bool smooth) {
+	if (samples->stride == 1) {
+		writeBytes(file, (const char *) (column + samples->first), samples->count * sizeof(double));
+		return;
+	}
+	double chunk[WRITER_SLACK / sizeof(double)];
+	size_t used = 0;
+	for (size_t row = 0; row < samples->count; row++) {
+		chunk[used++] = sampleValue(column, sampleIndex(samples, row), samples, smooth);
+		if (used == sizeof(chunk) / sizeof(double) || row + 1 == samples->count) {
+			writeBytes(file, (const char *) chunk, used * sizeof(double));
+			used = 0;
+		}
+	}
+}
+
+void printBinary(Writer *file, DumpKind kind, Variable *variable, Wave *wave, Analysed *analysed,
+        const DumpSamples *samples) {
+	DumpHeader header;
+	memset(&header, 0, sizeof(DumpHeader));
+	memcpy(header.magic, DUMP_MAGIC, DUMP_MAGIC_LENGTH);
+	header.version = DUMP_VERSION;
+	header.kind = kind;
+	header.byteOrder = DUMP_BYTE_ORDER;
+	header.columns = columns[kind];
+	header.rows = samples->count;
+	header.dataOffset = getDumpDataOffset();
+	header.startTime = sampleTime(samples, 0);
+	header.timeStep = samples->stride * samples->samplingTime;
+	fillHeader(&header, wave, analysed);
+	memcpy(header.column, columnName[kind], sizeof(header.column));
+	writeBytes(file, (const char *) &header, sizeof(DumpHeader));
+	char padding[DUMP_ALIGNMENT] = { 0 };
+	writeBytes(file, padding, header.dataOffset - sizeof(DumpHeader));
+	double **column[DUMP_COLUMNS];
+	locateColumns(kind, variable, column);
+	for (uint32_t current = 0; current < header.columns; current++) {
+		writeColumn(file, *column[current], samples, isWaveform(kind, current));
+	}
+}
+
+const char *getDumpExtension(DumpFormat format) {
+	return (format == BINARY_FORMAT ? "bin" : "data");
+}
+
+void viewDump(const DumpFile *dump, Variable *variable, Waveform *waveform, Wave wave[], Analysed *analysed) {
+	const DumpHeader *header = dump->header;
+	memset(variable, 0, sizeof(Variable));
+	memset(waveform, 0, sizeof(Waveform));
+	memset(wave, 0, NUMBER_OF_WAVE * sizeof(Wave));
+	memset(analysed, 0, sizeof(Analysed));
+	variable->wave = waveform;
+	double **column[DUMP_COLUMNS];
+	locateColumns(header->kind, variable, column);
+	for (uint32_t current = 0; current < header->columns; current++) {
+		*column[current] = (double *) getDumpColumn(dump, current);
+	}
+	for (int current = FIRST_WAVE; current < NUMBER_OF_WAVE; current++) {
+		variable->length[current] = waveform->length[current] = header->rows;
+		for (int blackhole = FIRST; blackhole < BH; blackhole++) {
+			wave[current].binary.mass[blackhole] = header->wave[current].mass[blackhole];
+			wave[current].binary.spin.magnitude[blackhole] = header->wave[current].magnitude[blackhole];
+			wave[current].binary.spin.inclination[blackhole] = header->wave[current].inclination[blackhole];
+			wave[current].binary.spin.azimuth[blackhole] = header->wave[current].azimuth[blackhole];
+		}
+		strncpy(wave[current].method.spin, header->wave[current].spin, STRING_LENGTH - 1);
+		wave[current].method.phase = header->wave[current].phase;
+		wave[current].method.amplitude = header->wave[current].amplitude;
+		analysed->period[current] = header->analysed.period[current];
+		analysed->length[current] = header->analysed.length[current];
+	}
+	memcpy(analysed->match, header->analysed.match, sizeof(analysed->match));
+	analysed->relativePeriod = header->analysed.relativePeriod;
+	analysed->relativeLength = header->analysed.relativeLength;
+	variable->size = waveform->size = header->rows;
+}
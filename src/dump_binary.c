@@ -0,0 +1,105 @@
+/**	@file   dump_binary.c
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Columnar binary dump format and its memory mapped reader.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "dump_binary.h"
+
+const char *getDumpName(DumpKind kind) {
+	static const char *name[NUMBER_OF_DUMP] = { "spin", "system", "wave" };
+	return (kind < NUMBER_OF_DUMP ? name[kind] : "unknown");
+}
+
+/**
+ * Checks the header against the size of the file.
+ * @param[in] header the header.
+ * @param[in] size   size of the file.
+ * @return NULL if the header is valid, otherwise the reason.
+ */
+static const char *checkHeader(const DumpHeader *header, size_t size) {
+	if (size < sizeof(DumpHeader) || memcmp(header->magic, DUMP_MAGIC, DUMP_MAGIC_LENGTH)) {
+		return ("not a binary dump");
+	}
+	if (header->byteOrder != DUMP_BYTE_ORDER) {
+		return ("foreign byte order");
+	}
+	if (header->version != DUMP_VERSION) {
+		return ("unsupported version");
+	}
+	if (header->kind >= NUMBER_OF_DUMP || header->columns > DUMP_COLUMNS || header->dataOffset % sizeof(double)) {
+		return ("corrupt header");
+	}
+	size_t columns = header->columns ? header->columns : 1;
+	if (header->dataOffset > size || (size - header->dataOffset) / sizeof(double) / columns < header->rows) {
+		return ("truncated file");
+	}
+	return (NULL);
+}
+
+DumpFile *openDump(const char *path) {
+	int descriptor = open(path, O_RDONLY);
+	if (descriptor < 0) {
+		fprintf(stderr, "Couldn't open file %s for reading; %s\n", path, strerror(errno));
+		return (NULL);
+	}
+	struct stat status;
+	if (fstat(descriptor, &status)) {
+		fprintf(stderr, "Couldn't read file %s; %s\n", path, strerror(errno));
+		close(descriptor);
+		return (NULL);
+	}
+	size_t size = (size_t) status.st_size;
+	void *map = size ? mmap(NULL, size, PROT_READ, MAP_PRIVATE, descriptor, 0) : MAP_FAILED;
+	close(descriptor);
+	if (map == MAP_FAILED) {
+		fprintf(stderr, "Couldn't map file %s; %s\n", path, size ? strerror(errno) : "empty file");
+		return (NULL);
+	}
+	const char *reason = checkHeader(map, size);
+	if (reason) {
+		fprintf(stderr, "Couldn't read file %s; %s\n", path, reason);
+		munmap(map, size);
+		return (NULL);
+	}
+	madvise(map, size, MADV_SEQUENTIAL);
+	DumpFile *dump = malloc(sizeof(DumpFile));
+	dump->map = map;
+	dump->header = map;
+	dump->size = size;
+	return (dump);
+}
+
+void closeDump(DumpFile **dump) {
+	munmap((void *) (*dump)->map, (*dump)->size);
+	free(*dump);
+	*dump = NULL;
+}
+
+const double *getDumpColumn(const DumpFile *dump, size_t column) {
+	if (column >= dump->header->columns) {
+		return (NULL);
+	}
+	return ((const double *) (dump->map + dump->header->dataOffset) + column * dump->header->rows);
+}
+
+const double *findDumpColumn(const DumpFile *dump, const char *name) {
+	for (size_t column = 0; column < dump->header->columns; column++) {
+		if (!strncmp(dump->header->column[column], name, DUMP_NAME)) {
+			return (getDumpColumn(dump, column));
+		}
+	}
+	return (NULL);
+}
+
+double getDumpTime(const DumpFile *dump, size_t row) {
+	return (dump->header->startTime + row * dump->header->timeStep);
+}
@@ -0,0 +1,80 @@
+/**	@file   engine.c
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Generation and matching of pairs for the programs linking the library.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "engine.h"
+#include "generator_lal.h"
+
+struct Engine {
+	Parameter parameter;	///< band and sampling of the pairs.
+	MatchContext *context;	///< buffers, plans and noise spectrum of the matching.
+};
+
+Engine *createEngine(const Parameter *parameter) {
+	Engine *engine = calloc(1, sizeof(Engine));
+	if (!engine) {
+		return (NULL);
+	}
+	engine->parameter = *parameter;
+	engine->context = createMatchContext();
+	if (!engine->context) {
+		free(engine);
+		return (NULL);
+	}
+	return (engine);
+}
+
+int matchWithEngine(Engine *engine, const Wave pair[], Analysed *analysed) {
+	return (projectWithEngine(engine, pair, 0, NULL, NULL, analysed));
+}
+
+int projectWithEngine(Engine *engine, const Wave pair[], size_t count, const Antenna antenna[], double match[],
+        Analysed *analysed) {
+	const Parameter *parameter = &engine->parameter;
+	Wave wave[NUMBER_OF_WAVE];
+	memcpy(wave, pair, sizeof(wave));
+	memset(analysed, 0, sizeof(Analysed));
+	if (count) {
+		memset(match, 0, count * sizeof(double));
+	}
+	Variable *variable = generateWaveformPair(wave, parameter->initialFrequency, parameter->samplingTime);
+	if (!variable->length[FIRST_WAVE] || !variable->length[SECOND_WAVE]) {
+		destroyWaveform(&variable->wave);
+		destroyOutput(&variable);
+		return (FAILURE);
+	}
+	size_t minIndex, maxIndex;
+	prepareMatch(engine->context, variable->wave);
+	prepareNoise(engine->context, parameter->initialFrequency, parameter->samplingFrequency);
+	indexFromFrequency(parameter->initialFrequency, parameter->endingFrequency,
+	        parameter->samplingFrequency / variable->size, &minIndex, &maxIndex);
+	if (count) {
+		computeProjectedMatches(engine->context, minIndex, maxIndex, count, antenna, match);
+	}
+	computeMatches(engine->context, minIndex, maxIndex, analysed);
+	computePeriods(engine->context, parameter->samplingTime, analysed);
+	finishMatch(engine->context);
+	destroyWaveform(&variable->wave);
+	destroyOutput(&variable);
+	return (SUCCESS);
+}
+
+size_t matchBatchWithEngine(Engine *engine, size_t count, const PairJob job[], Analysed analysed[]) {
+	size_t failed = 0;
+	for (size_t current = 0; current < count; current++) {
+		failed += matchWithEngine(engine, job[current].pair, &analysed[current]) != SUCCESS;
+	}
+	return (failed);
+}
+
+void destroyEngine(Engine **engine) {
+	if (*engine) {
+		destroyMatchContext(&(*engine)->context);
+	}
+	free(*engine);
+	*engine = NULL;
+}
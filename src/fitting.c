@@ -0,0 +1,414 @@
+/**	@file   fitting.c
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Fitting factor of a template family to a target wave.
+ */
+
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fitting.h"
+#include "generator_lal.h"
+#include "util_math.h"
+
+/** Constants of the search. */
+enum {
+	FIT_VERTEX = FIT_DIMENSION + 1,	///< number of the vertices of the simplex.
+	FIT_CACHE = 256,	///< number of the evaluations remembered by a restart, a power of two.
+};
+
+static const double REFLECTION = 1.0;	///< distance of the reflected vertex from the centroid.
+static const double EXPANSION = 2.0;	///< the expanded vertex is this times farther than the reflected one.
+static const double CONTRACTION = 0.5;	///< the contracted vertex is this times closer than the reflected one.
+static const double SHRINKING = 0.5;	///< factor of the shrinking towards the best vertex.
+static const double INITIAL_STEP = 0.1;	///< edge of the initial simplex relative to the width of the bounds.
+
+/** An evaluated template. */
+typedef struct {
+	double point[FIT_DIMENSION];	///< the searched fields.
+	double match;	///< the match.
+	bool used;	///< the entry holds an evaluation.
+} CachedFit;
+
+/** Outcome of a restart. */
+typedef struct {
+	double point[FIT_DIMENSION];	///< the best vertex.
+	double match;	///< its match.
+	size_t evaluations;	///< number of the generated templates.
+	size_t cached;	///< number of the evaluations answered from the cache.
+} Restart;
+
+/** State of the search shared by the threads. */
+typedef struct {
+	const Parameter *parameter;	///< band and sampling.
+	const Wave *pair;	///< the target and the template.
+	const FitOption *option;	///< settings.
+	double *target[WAVE];	///< polarisations of the target.
+	size_t length;	///< length of the target.
+	size_t size;	///< padded length every restart starts with, the same for every thread.
+	Restart *restart;	///< outcomes of the restarts.
+	size_t next;	///< index of the next restart to run.
+	pthread_mutex_t lock;	///< protects next.
+} Search;
+
+/** Buffers of a thread. */
+typedef struct {
+	Search *search;	///< the search.
+	MatchContext *context;	///< plans and noise spectrum, holds the orthonormalised target.
+	Waveform *waveform;	///< the target and the template, padded to a power of two.
+	size_t band[MINMAX];	///< indices of the band.
+	CachedFit cache[FIT_CACHE];	///< evaluations of the current restart.
+	Restart *current;	///< the running restart.
+} Fitter;
+
+static void getPoint(const Wave *wave, double point[FIT_DIMENSION]) {
+	point[FIT_MASS1] = wave->binary.mass[FIRST];
+	point[FIT_MASS2] = wave->binary.mass[SECOND];
+	point[FIT_MAGNITUDE1] = wave->binary.spin.magnitude[FIRST];
+	point[FIT_MAGNITUDE2] = wave->binary.spin.magnitude[SECOND];
+}
+
+static void setPoint(Wave *wave, const double point[FIT_DIMENSION]) {
+	wave->binary.mass[FIRST] = point[FIT_MASS1];
+	wave->binary.mass[SECOND] = point[FIT_MASS2];
+	wave->binary.spin.magnitude[FIRST] = point[FIT_MAGNITUDE1];
+	wave->binary.spin.magnitude[SECOND] = point[FIT_MAGNITUDE2];
+}
+
+static void clamp(const FitOption *option, double point[FIT_DIMENSION]) {
+	for (int field = 0; field < FIT_DIMENSION; field++) {
+		point[field] = fmin(fmax(point[field], option->bound[MIN][field]), option->bound[MAX][field]);
+	}
+}
+
+static size_t getPaddedSize(size_t length) {
+	size_t size = 1;
+	while (size < length) {
+		size <<= 1;
+	}
+	return (size);
+}
+
+/**
+ * Replaces the buffers by ones of the size and copies the target into them. The context transforms
+ * and orthonormalises the target again.
+ * @param[in,out] fitter the buffers of the thread.
+ * @param[in]     size   the padded length.
+ */
+static void allocate(Fitter *fitter, size_t size) {
+	if (fitter->waveform) {
+		destroyWaveform(&fitter->waveform);
+	}
+	const Search *search = fitter->search;
+	const Parameter *parameter = search->parameter;
+	fitter->waveform = createWaveform(size, size);
+	for (int component = HP; component < WAVE; component++) {
+		memcpy(fitter->waveform->h[HP1 + component], search->target[component], search->length * sizeof(double));
+	}
+	prepareMatch(fitter->context, fitter->waveform);
+	prepareNoise(fitter->context, parameter->initialFrequency, parameter->samplingFrequency);
+	indexFromFrequency(parameter->initialFrequency, parameter->endingFrequency, parameter->samplingFrequency / size,
+	        &fitter->band[MIN], &fitter->band[MAX]);
+}
+
+/**
+ * Grows the buffers to the power of two not shorter than the length, if needed. The growth lasts until
+ * the end of the restart only, so the results don't depend on the restarts run before by the thread.
+ * @param[in,out] fitter the buffers of the thread.
+ * @param[in]     length length of the next template.
+ */
+static void resize(Fitter *fitter, size_t length) {
+	if (length > fitter->waveform->size) {
+		allocate(fitter, getPaddedSize(length));
+	}
+}
+
+static size_t hashPoint(const double point[FIT_DIMENSION]) {
+	const unsigned char *byte = (const unsigned char *) point;
+	uint64_t hash = 14695981039346656037u;
+	for (size_t index = 0; index < FIT_DIMENSION * sizeof(double); index++) {
+		hash = (hash ^ byte[index]) * 1099511628211u;
+	}
+	return ((size_t) hash & (FIT_CACHE - 1));
+}
+
+/**
+ * Generates the template of the point and matches it with the held target. The points visited again,
+ * by the shrinking or at the bounds, are answered from the cache of the restart.
+ * @param[in,out] fitter the buffers of the thread.
+ * @param[in]     point  the searched fields.
+ * @return the match, 0 if the template couldn't be generated.
+ */
+static double evaluate(Fitter *fitter, const double point[FIT_DIMENSION]) {
+	CachedFit *entry = &fitter->cache[hashPoint(point)];
+	if (entry->used && !memcmp(entry->point, point, sizeof(entry->point))) {
+		fitter->current->cached++;
+		return (entry->match);
+	}
+	const Search *search = fitter->search;
+	const Parameter *parameter = search->parameter;
+	Wave template = search->pair[SECOND_WAVE];
+	setPoint(&template, point);
+	fitter->current->evaluations++;
+	double match = 0.0;
+	WaveSeries series;
+	if (!generateWave(&template, parameter->initialFrequency, parameter->samplingTime, &series) && series.length) {
+		resize(fitter, series.length);
+		size_t size = fitter->waveform->size;
+		for (int component = HP; component < WAVE; component++) {
+			double *h = fitter->waveform->h[HP2 + component];
+			memcpy(h, series.h[component], series.length * sizeof(double));
+			memset(h + series.length, 0, (size - series.length) * sizeof(double));
+		}
+		Analysed analysed;
+		computeMatches(fitter->context, fitter->band[MIN], fitter->band[MAX], &analysed);
+		match = analysed.match[search->option->kind];
+	}
+	releaseWave(&template, &series);
+	memcpy(entry->point, point, sizeof(entry->point));
+	entry->match = match;
+	entry->used = true;
+	return (match);
+}
+
+/** Sorts the vertices by decreasing match. */
+static void order(double vertex[FIT_VERTEX][FIT_DIMENSION], double match[FIT_VERTEX]) {
+	for (int current = 1; current < FIT_VERTEX; current++) {
+		double point[FIT_DIMENSION];
+		double value = match[current];
+		memcpy(point, vertex[current], sizeof(point));
+		int index = current;
+		for (; index > 0 && match[index - 1] < value; index--) {
+			match[index] = match[index - 1];
+			memcpy(vertex[index], vertex[index - 1], sizeof(point));
+		}
+		match[index] = value;
+		memcpy(vertex[index], point, sizeof(point));
+	}
+}
+
+/**
+ * Places a point on the line of the centroid and the worst vertex, clamped to the bounds.
+ * @param[in]  option   the bounds.
+ * @param[in]  centroid centroid of the other vertices.
+ * @param[in]  worst    the worst vertex.
+ * @param[in]  factor   position of the point, 1 is the worst vertex, -1 its reflection.
+ * @param[out] point    the point.
+ */
+static void place(const FitOption *option, const double centroid[FIT_DIMENSION], const double worst[FIT_DIMENSION],
+        double factor, double point[FIT_DIMENSION]) {
+	for (int field = 0; field < FIT_DIMENSION; field++) {
+		point[field] = centroid[field] + factor * (worst[field] - centroid[field]);
+	}
+	clamp(option, point);
+}
+
+/**
+ * Maximises the match by a Nelder–Mead simplex from the starting point, until its matches differ less
+ * than the tolerance or the evaluations run out.
+ * @param[in,out] fitter  the buffers of the thread.
+ * @param[in]     start   the starting point.
+ * @param[out]    restart the best vertex.
+ */
+static void searchSimplex(Fitter *fitter, const double start[FIT_DIMENSION], Restart *restart) {
+	const FitOption *option = fitter->search->option;
+	double vertex[FIT_VERTEX][FIT_DIMENSION], match[FIT_VERTEX];
+	memset(fitter->cache, 0, sizeof(fitter->cache));
+	fitter->current = restart;
+	if (fitter->waveform->size != fitter->search->size) {
+		allocate(fitter, fitter->search->size);
+	}
+	for (int current = 0; current < FIT_VERTEX; current++) {
+		memcpy(vertex[current], start, sizeof(vertex[current]));
+		if (current) {
+			int field = current - 1;
+			double step = INITIAL_STEP * (option->bound[MAX][field] - option->bound[MIN][field]);
+			vertex[current][field] += vertex[current][field] + step > option->bound[MAX][field] ? -step : step;
+		}
+		match[current] = evaluate(fitter, vertex[current]);
+	}
+	size_t steps = FIT_VERTEX;
+	double *worst = vertex[FIT_DIMENSION];
+	for (order(vertex, match); steps < option->evaluations && match[0] - match[FIT_DIMENSION] >= option->tolerance;
+	        order(vertex, match)) {
+		double centroid[FIT_DIMENSION] = { 0.0 };
+		for (int current = 0; current < FIT_DIMENSION; current++) {
+			for (int field = 0; field < FIT_DIMENSION; field++) {
+				centroid[field] += vertex[current][field] / FIT_DIMENSION;
+			}
+		}
+		double reflected[FIT_DIMENSION], trial[FIT_DIMENSION];
+		place(option, centroid, worst, -REFLECTION, reflected);
+		double atReflected = evaluate(fitter, reflected);
+		steps++;
+		if (atReflected > match[0]) {
+			place(option, centroid, worst, -REFLECTION * EXPANSION, trial);
+			double atTrial = evaluate(fitter, trial);
+			steps++;
+			memcpy(worst, atTrial > atReflected ? trial : reflected, sizeof(trial));
+			match[FIT_DIMENSION] = atTrial > atReflected ? atTrial : atReflected;
+		} else if (atReflected > match[FIT_DIMENSION - 1]) {
+			memcpy(worst, reflected, sizeof(reflected));
+			match[FIT_DIMENSION] = atReflected;
+		} else {
+			bool outside = atReflected > match[FIT_DIMENSION];
+			place(option, centroid, worst, outside ? -REFLECTION * CONTRACTION : CONTRACTION, trial);
+			double atTrial = evaluate(fitter, trial);
+			steps++;
+			if (outside ? atTrial >= atReflected : atTrial > match[FIT_DIMENSION]) {
+				memcpy(worst, trial, sizeof(trial));
+				match[FIT_DIMENSION] = atTrial;
+				continue;
+			}
+			for (int current = 1; current < FIT_VERTEX; current++) {
+				for (int field = 0; field < FIT_DIMENSION; field++) {
+					vertex[current][field] = vertex[0][field] + SHRINKING * (vertex[current][field] - vertex[0][field]);
+				}
+				match[current] = evaluate(fitter, vertex[current]);
+				steps++;
+			}
+		}
+	}
+	memcpy(restart->point, vertex[0], sizeof(restart->point));
+	restart->match = match[0];
+}
+
+/**
+ * Gives the starting point of the restart, the template for the first one, a random point between the
+ * bounds for the others, drawn from the stream of the restart.
+ */
+static void startingPoint(const Search *search, size_t index, double point[FIT_DIMENSION]) {
+	const FitOption *option = search->option;
+	if (!index) {
+		getPoint(&search->pair[SECOND_WAVE], point);
+		clamp(option, point);
+		return;
+	}
+	RandomStream stream;
+	initializeRandomStream(&stream, option->seed, index);
+	for (int field = 0; field < FIT_DIMENSION; field++) {
+		point[field] = randomStreamBetween(&stream, option->bound[MIN][field], option->bound[MAX][field]);
+	}
+}
+
+/**
+ * Runs the restarts not yet taken by the other threads.
+ * @param[in,out] argument the Fitter of the thread.
+ * @return NULL
+ */
+static void *runRestarts(void *argument) {
+	Fitter *fitter = argument;
+	Search *search = fitter->search;
+	for (;;) {
+		pthread_mutex_lock(&search->lock);
+		size_t index = search->next++;
+		pthread_mutex_unlock(&search->lock);
+		if (index >= search->option->restarts) {
+			break;
+		}
+		double start[FIT_DIMENSION];
+		startingPoint(search, index, start);
+		searchSimplex(fitter, start, &search->restart[index]);
+	}
+	return (NULL);
+}
+
+/**
+ * Gives the padded length of the longest template of the bounds, estimated by the chirp time at the
+ * lower mass corner, but not shorter than the target.
+ */
+static size_t estimateSize(const Search *search) {
+	const Parameter *parameter = search->parameter;
+	Wave corner = search->pair[SECOND_WAVE];
+	double point[FIT_DIMENSION];
+	getPoint(&corner, point);
+	point[FIT_MASS1] = search->option->bound[MIN][FIT_MASS1];
+	point[FIT_MASS2] = search->option->bound[MIN][FIT_MASS2];
+	setPoint(&corner, point);
+	double length = ceil(estimateLength(&corner, parameter->initialFrequency, parameter->samplingTime));
+	return (getPaddedSize(length > (double) search->length ? (size_t) length : search->length));
+}
+
+/**
+ * Generates the target and keeps its polarisations.
+ * @return failure code
+ */
+static int generateTarget(Search *search) {
+	const Parameter *parameter = search->parameter;
+	Wave target = search->pair[FIRST_WAVE];
+	WaveSeries series;
+	int failure = generateWave(&target, parameter->initialFrequency, parameter->samplingTime, &series);
+	if (!failure && series.length) {
+		search->length = series.length;
+		for (int component = HP; component < WAVE; component++) {
+			search->target[component] = malloc(series.length * sizeof(double));
+			memcpy(search->target[component], series.h[component], series.length * sizeof(double));
+		}
+	}
+	releaseWave(&target, &series);
+	return (search->length ? SUCCESS : FAILURE);
+}
+
+int findFittingFactor(const Parameter *parameter, const Wave pair[], const FitOption *option,
+        FittingFactor *result) {
+	memset(result, 0, sizeof(FittingFactor));
+	result->template = pair[SECOND_WAVE];
+	Search search = { parameter, pair, option, { NULL, NULL }, 0, 0, NULL, 0, PTHREAD_MUTEX_INITIALIZER };
+	if (!option->restarts || generateTarget(&search)) {
+		return (FAILURE);
+	}
+	search.size = estimateSize(&search);
+	size_t threads = option->threads < option->restarts ? option->threads : option->restarts;
+	threads = threads ? threads : 1;
+	search.restart = calloc(option->restarts, sizeof(Restart));
+	Fitter *fitter = calloc(threads, sizeof(Fitter));
+	pthread_t *thread = calloc(threads, sizeof(pthread_t));
+	bool *started = calloc(threads, sizeof(bool));
+	int failure = SUCCESS;
+	for (size_t current = 0; current < threads && !failure; current++) {
+		fitter[current].search = &search;
+		fitter[current].context = createMatchContext();
+		if (!fitter[current].context) {
+			failure = FAILURE;
+			break;
+		}
+		holdFirstWave(fitter[current].context, true);
+		allocate(&fitter[current], search.size);
+	}
+	if (!failure) {
+		for (size_t current = 1; current < threads; current++) {
+			started[current] = !pthread_create(&thread[current], NULL, runRestarts, &fitter[current]);
+		}
+		runRestarts(&fitter[0]);
+		for (size_t current = 1; current < threads; current++) {
+			if (started[current]) {
+				pthread_join(thread[current], NULL);
+			}
+		}
+		result->match = -1.0;
+		for (size_t index = 0; index < option->restarts; index++) {
+			result->evaluations += search.restart[index].evaluations;
+			result->cached += search.restart[index].cached;
+			if (search.restart[index].match > result->match) {
+				result->match = search.restart[index].match;
+				result->restart = index;
+			}
+		}
+		setPoint(&result->template, search.restart[result->restart].point);
+	}
+	for (size_t current = 0; current < threads; current++) {
+		if (fitter[current].waveform) {
+			destroyWaveform(&fitter[current].waveform);
+		}
+		destroyMatchContext(&fitter[current].context);
+	}
+	for (int component = HP; component < WAVE; component++) {
+		free(search.target[component]);
+	}
+	free(started);
+	free(thread);
+	free(fitter);
+	free(search.restart);
+	return (failure);
+}
@@ -0,0 +1,248 @@
+/**	@file   generator_chirp.c
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Analytic restricted post-Newtonian chirp without LAL.
+ *
+ *	The orbital frequency and phase follow the TaylorT3 expansion in the dimensionless time
+ *	\f$\theta=(\eta\tau/5M)^{-1/8}\f$ up to the second PN order, the amplitude is Newtonian. If the spins
+ *	have components in the orbital plane and the spin contribution is not "NO", the orbital plane
+ *	precesses rigidly around the total angular momentum with the leading order rate. The backend is
+ *	meant for the tests and the benchmarks of the matching, not for the physics.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "generator.h"
+
+/** Various constants. */
+enum {
+	MEGA = 1000000,
+	BISECTION = 200,	///< number of the steps finding the starting time.
+	SERIES = WAVE + 2 + 4 * DIMENSION,	///< number of the arrays of a wave.
+};
+
+static const double SOLAR_MASS_TIME = 4.925491025543576e-06;	///< \f$GM_\odot/c^3\f$ in seconds.
+static const double PARSEC = 3.085677581491367e16;	///< parsec in meters.
+static const double LIGHT_SPEED = 299792458.0;	///< speed of light in m/s.
+
+/** Constants of a wave during the generation. */
+typedef struct {
+	double totalTime;	///< total mass in seconds.
+	double eta;	///< symmetric mass ratio.
+	int order;	///< double of the PN order in phase, at most 4.
+	double omega[5];	///< coefficients of the orbital frequency.
+	double phi[5];	///< coefficients of the orbital phase.
+} Chirp;
+
+static void initChirp(Chirp *chirp, const Wave *wave) {
+	double totalMass = wave->binary.mass[0] + wave->binary.mass[1];
+	double eta = wave->binary.mass[0] * wave->binary.mass[1] / (totalMass * totalMass);
+	memset(chirp, 0, sizeof(Chirp));
+	chirp->totalTime = totalMass * SOLAR_MASS_TIME;
+	chirp->eta = eta;
+	chirp->order = wave->method.phase < 0 ? 0 : wave->method.phase > 4 ? 4 : wave->method.phase;
+	chirp->omega[0] = chirp->phi[0] = 1.0;
+	if (chirp->order >= 2) {
+		chirp->omega[2] = 743.0 / 2688.0 + 11.0 / 32.0 * eta;
+		chirp->phi[2] = 3715.0 / 8064.0 + 55.0 / 96.0 * eta;
+	}
+	if (chirp->order >= 3) {
+		chirp->omega[3] = -3.0 * M_PI / 10.0;
+		chirp->phi[3] = -3.0 * M_PI / 4.0;
+	}
+	if (chirp->order >= 4) {
+		chirp->omega[4] = 1855099.0 / 14450688.0 + 56975.0 / 258048.0 * eta + 371.0 / 2048.0 * eta * eta;
+		chirp->phi[4] = 9275495.0 / 14450688.0 + 284875.0 / 258048.0 * eta + 1855.0 / 2048.0 * eta * eta;
+	}
+}
+
+/**
+ * Evaluates the series in theta.
+ * @param[in] coefficient the coefficients.
+ * @param[in] theta       the dimensionless time.
+ * @return the value
+ */
+static double evaluate(const double coefficient[5], double theta) {
+	double theta2 = theta * theta;
+	return (1.0 + theta2 * (coefficient[2] + theta * coefficient[3] + theta2 * coefficient[4]));
+}
+
+/**
+ * Returns the orbital frequency in the units of the total mass.
+ * @param[in] chirp constants of the wave.
+ * @param[in] tau   dimensionless time before the coalescence.
+ * @return \f$\omega M\f$
+ */
+static double getOmega(const Chirp *chirp, double tau) {
+	double theta = pow(tau, -1.0 / 8.0);
+	return (theta * theta * theta / 8.0 * evaluate(chirp->omega, theta));
+}
+
+static double getPhase(const Chirp *chirp, double tau) {
+	double theta = pow(tau, -1.0 / 8.0);
+	return (-pow(theta, -5.0) / chirp->eta * evaluate(chirp->phi, theta));
+}
+
+/**
+ * Finds the dimensionless time where the gravitational wave frequency equals the initial frequency.
+ * @param[in] chirp            constants of the wave.
+ * @param[in] initialFrequency starting frequency
+ * @return the dimensionless time
+ */
+static double findStart(const Chirp *chirp, double initialFrequency) {
+	double omega = M_PI * chirp->totalTime * initialFrequency;
+	double newtonian = pow(8.0 * omega, -8.0 / 3.0);
+	double bound[MINMAX] = { log(newtonian / 64.0), log(newtonian * 64.0) };
+	for (int step = 0; step < BISECTION; step++) {
+		double middle = (bound[MIN] + bound[MAX]) / 2.0;
+		bound[getOmega(chirp, exp(middle)) > omega ? MIN : MAX] = middle;
+	}
+	return (exp((bound[MIN] + bound[MAX]) / 2.0));
+}
+
+/**
+ * Returns the dimensionless time of the sample and whether the inspiral continues there.
+ * @param[in]     chirp    constants of the wave.
+ * @param[in]     start    dimensionless time of the first sample.
+ * @param[in]     step     dimensionless time between the samples.
+ * @param[in]     index    index of the sample.
+ * @param[in,out] previous frequency of the previous sample.
+ * @return the dimensionless time, or non-positive after the end.
+ */
+static double advance(const Chirp *chirp, double start, double step, size_t index, double *previous) {
+	static const double ISCO = 0.06804138174397717;	///< \f$6^{-3/2}\f$
+	double tau = start - index * step;
+	if (tau <= 0.0) {
+		return (0.0);
+	}
+	double omega = getOmega(chirp, tau);
+	if (omega >= ISCO || omega <= *previous) {
+		return (0.0);
+	}
+	*previous = omega;
+	return (tau);
+}
+
+/**
+ * Rotates the vector around the unit axis.
+ * @param[in]  axis   the unit axis.
+ * @param[in]  cosine cosine of the angle.
+ * @param[in]  sine   sine of the angle.
+ * @param[in]  vector the vector.
+ * @param[out] result the rotated vector.
+ */
+static void rotate(const double axis[DIMENSION], double cosine, double sine, const double vector[DIMENSION],
+        double result[DIMENSION]) {
+	double dot = axis[X] * vector[X] + axis[Y] * vector[Y] + axis[Z] * vector[Z];
+	double cross[DIMENSION] = { axis[Y] * vector[Z] - axis[Z] * vector[Y], axis[Z] * vector[X]
+	        - axis[X] * vector[Z], axis[X] * vector[Y] - axis[Y] * vector[X] };
+	for (int dimension = X; dimension < DIMENSION; dimension++) {
+		result[dimension] = vector[dimension] * cosine + cross[dimension] * sine
+		        + axis[dimension] * dot * (1.0 - cosine);
+	}
+}
+
+/** Orientation of the binary. */
+typedef struct {
+	double axis[DIMENSION];	///< direction of the total angular momentum.
+	double rate;	///< precession rate per \f$v^6\f$ in the units of the total mass.
+	double vector[4][DIMENSION];	///< initial spins, orbital plane axis and normal.
+} Orientation;
+
+static bool initOrientation(Orientation *orientation, const Wave *wave, double velocity) {
+	double totalMass = wave->binary.mass[0] + wave->binary.mass[1];
+	double inclination = wave->binary.inclination;
+	double normal[DIMENSION] = { sin(inclination), 0.0, cos(inclination) };
+	double axis[DIMENSION] = { cos(inclination), 0.0, -sin(inclination) };
+	double eta = wave->binary.mass[0] * wave->binary.mass[1] / (totalMass * totalMass);
+	double momentum = eta / velocity, magnitude = 0.0, perpendicular = 0.0;
+	for (int dimension = X; dimension < DIMENSION; dimension++) {
+		orientation->vector[0][dimension] = wave->binary.spin.component[0][dimension];
+		orientation->vector[1][dimension] = wave->binary.spin.component[1][dimension];
+		orientation->vector[2][dimension] = axis[dimension];
+		orientation->vector[3][dimension] = normal[dimension];
+		orientation->axis[dimension] = momentum * normal[dimension];
+		for (int blackhole = 0; blackhole < BH; blackhole++) {
+			double fraction = wave->binary.mass[blackhole] / totalMass;
+			orientation->axis[dimension] += fraction * fraction * wave->binary.spin.component[blackhole][dimension];
+		}
+		magnitude += orientation->axis[dimension] * orientation->axis[dimension];
+	}
+	magnitude = sqrt(magnitude);
+	for (int dimension = X; dimension < DIMENSION; dimension++) {
+		orientation->axis[dimension] /= magnitude;
+		double difference = orientation->axis[dimension] - normal[dimension];
+		perpendicular += difference * difference;
+	}
+	orientation->rate = (2.0 + 1.5 * wave->binary.mass[1] / wave->binary.mass[0]) * magnitude;
+	return (!strstr(wave->method.spin, "NO") && perpendicular > 1e-24);
+}
+
+static int generateChirp(const Wave *wave, double initialFrequency, double samplingTime, WaveSeries *series) {
+	Chirp chirp;
+	initChirp(&chirp, wave);
+	double start = findStart(&chirp, initialFrequency);
+	double step = chirp.eta * samplingTime / (5.0 * chirp.totalTime);
+	double previous = 0.0;
+	size_t length = 0;
+	while (advance(&chirp, start, step, length, &previous) > 0.0) {
+		length++;
+	}
+	memset(series, 0, sizeof(WaveSeries));
+	if (!length) {
+		return (FAILURE);
+	}
+	double *data = malloc(SERIES * length * sizeof(double));
+	if (!data) {
+		return (FAILURE);
+	}
+	double **array[SERIES] = { &series->h[HP], &series->h[HC], &series->V, &series->Phi, &series->S1[X],
+	        &series->S1[Y], &series->S1[Z], &series->S2[X], &series->S2[Y], &series->S2[Z], &series->E1[X],
+	        &series->E1[Y], &series->E1[Z], &series->E3[X], &series->E3[Y], &series->E3[Z] };
+	for (int current = 0; current < SERIES; current++) {
+		*array[current] = data + current * length;
+	}
+	series->handle = data;
+	series->length = length;
+	Orientation orientation;
+	double velocity = cbrt(getOmega(&chirp, start));
+	bool precessing = initOrientation(&orientation, wave, velocity);
+	double amplitude = 4.0 * chirp.eta * chirp.totalTime * LIGHT_SPEED / (wave->binary.distance * MEGA * PARSEC);
+	double initialPhase = getPhase(&chirp, start), angle = 0.0;
+	double **target[4] = { series->S1, series->S2, series->E1, series->E3 };
+	previous = 0.0;
+	for (size_t index = 0; index < length; index++) {
+		double tau = advance(&chirp, start, step, index, &previous);
+		velocity = cbrt(previous);
+		double phase = getPhase(&chirp, tau) - initialPhase;
+		double cosine = cos(angle), sine = sin(angle), rotated[DIMENSION];
+		for (int vector = 0; vector < 4; vector++) {
+			rotate(orientation.axis, cosine, sine, orientation.vector[vector], rotated);
+			for (int dimension = X; dimension < DIMENSION; dimension++) {
+				target[vector][dimension][index] = rotated[dimension];
+			}
+		}
+		double projection = series->E3[Z][index];
+		double strain = amplitude * velocity * velocity;
+		series->h[HP][index] = strain * (1.0 + projection * projection) / 2.0 * cos(2.0 * phase);
+		series->h[HC][index] = strain * projection * sin(2.0 * phase);
+		series->V[index] = velocity;
+		series->Phi[index] = phase;
+		if (precessing) {
+			angle += orientation.rate * pow(velocity, 6.0) * samplingTime / chirp.totalTime;
+		}
+	}
+	return (SUCCESS);
+}
+
+/**
+ * Frees the arrays allocated in one block.
+ */
+static void releaseChirp(WaveSeries *series) {
+	free(series->handle);
+	memset(series, 0, sizeof(WaveSeries));
+}
+
+const GeneratorBackend chirpGenerator = { "chirp", generateChirp, releaseChirp };
@@ -11,11 +11,13 @@
 #include <lal/LALDatatypes.h>
 #include <lal/LALSimInspiral.h>
 #include <lal/TimeSeries.h>
+#include "generator.h"
 #include "generator_lal.h"
+#include "timing.h"
 
 /** Various constants. */
 enum {
-	HP, HC, WAVE, MEGA = 1000000,
+	MEGA = 1000000,
 };
 
 /**
@@ -139,17 +141,15 @@ static void destroyTimeSeries(TimeSeries *timeSeries) {
 
 /**
  * Creates outputs.
- * @param[in]  timeSeries generated time series.
- * @param[out] variable     ?
- * @return failure code
+ * @param[in]  series generated series.
+ * @return the output
  */
-static Variable *createOutput(TimeSeries timeSeries[NUMBER_OF_WAVE]) {
+static Variable *createOutput(WaveSeries series[NUMBER_OF_WAVE]) {
 	Variable *variable = calloc(1, sizeof(Variable));
-	variable->size =
-	        timeSeries[FIRST_WAVE].h[HP]->data->length > timeSeries[SECOND_WAVE].h[HC]->data->length ?
-	                timeSeries[FIRST_WAVE].h[HP]->data->length : timeSeries[SECOND_WAVE].h[HC]->data->length;
+	variable->size = series[FIRST_WAVE].length > series[SECOND_WAVE].length ? series[FIRST_WAVE].length
+	        : series[SECOND_WAVE].length;
 	for (int wave = FIRST_WAVE; wave < NUMBER_OF_WAVE; wave++) {
-		variable->length[wave] = timeSeries[wave].h[HP]->data->length;
+		variable->length[wave] = series[wave].length;
 		variable->V[wave] = calloc(variable->size, sizeof(double));
 		variable->Phi[wave] = calloc(variable->size, sizeof(double));
 		for (int dimension = X; dimension < DIMENSION; dimension++) {
@@ -177,37 +177,31 @@ void destroyOutput(Variable **variable) {
 	free(*variable);
 }
 
-static int fillOutput(TimeSeries timeSeries[NUMBER_OF_WAVE], Variable*variable) {
+static int fillOutput(WaveSeries series[NUMBER_OF_WAVE], Variable*variable) {
 	size_t size = sizeof(double);
 	double sqt2_2 = M_SQRT2 / 2.0;
 	for (int wave = FIRST_WAVE; wave < NUMBER_OF_WAVE; wave++) {
 		for (int component = HP; component < WAVE; component++) {
-			memcpy(variable->wave->h[2 * wave + component], timeSeries[wave].h[component]->data->data,
-			        variable->length[wave] * size);
+			memcpy(variable->wave->h[2 * wave + component], series[wave].h[component], variable->length[wave] * size);
 		}
 		for (size_t index = 0; index < variable->wave->length[wave]; index++) {
 			variable->wave->H[wave][index] = sqt2_2
 			        * (variable->wave->h[2 * wave][index] + variable->wave->h[2 * wave + 1][index]);
 		}
-		memcpy(variable->V[wave], timeSeries[wave].V->data->data, variable->length[wave] * size);
-		memcpy(variable->Phi[wave], timeSeries[wave].Phi->data->data, variable->length[wave] * size);
+		memcpy(variable->V[wave], series[wave].V, variable->length[wave] * size);
+		memcpy(variable->Phi[wave], series[wave].Phi, variable->length[wave] * size);
 		for (int dimension = X; dimension < DIMENSION; dimension++) {
-			memcpy(variable->S1[wave][dimension], timeSeries[wave].S1[dimension]->data->data,
-			        variable->length[wave] * size);
-			memcpy(variable->S2[wave][dimension], timeSeries[wave].S2[dimension]->data->data,
-			        variable->length[wave] * size);
-			memcpy(variable->E1[wave][dimension], timeSeries[wave].E1[dimension]->data->data,
-			        variable->length[wave] * size);
-			memcpy(variable->E3[wave][dimension], timeSeries[wave].E3[dimension]->data->data,
-			        variable->length[wave] * size);
+			memcpy(variable->S1[wave][dimension], series[wave].S1[dimension], variable->length[wave] * size);
+			memcpy(variable->S2[wave][dimension], series[wave].S2[dimension], variable->length[wave] * size);
+			memcpy(variable->E1[wave][dimension], series[wave].E1[dimension], variable->length[wave] * size);
+			memcpy(variable->E3[wave][dimension], series[wave].E3[dimension], variable->length[wave] * size);
 		}
 	}
 	return (SUCCESS);
 }
 
-static int generate(Wave *wave, double initialFrequency, double samplingTime, TimeSeries *timeSeries) {
+static int generate(const Wave *wave, double initialFrequency, double samplingTime, TimeSeries *timeSeries) {
 	int failure = SUCCESS;
-	convertSpinFromAnglesToXyz(&wave->binary.spin, wave->binary.inclination);
 	REAL8 e1[DIMENSION] = { +cos(wave->binary.inclination), 0.0, -sin(wave->binary.inclination) };
 	REAL8 e3[DIMENSION] = { +sin(wave->binary.inclination), 0.0, +cos(wave->binary.inclination) };
 	LALSimInspiralInteraction interactionFlags = getInteraction(wave->method.spin);
@@ -223,107 +217,110 @@ static int generate(Wave *wave, double initialFrequency, double samplingTime, Ti
 	return (failure);
 }
 
-Variable* generateWaveformPair(Wave parameter[], double initialFrequency, double samplingTime) {
-	TimeSeries timeSeries[NUMBER_OF_WAVE];
-	memset(timeSeries, 0, 2 * sizeof(TimeSeries));
-	for (int wave = FIRST_WAVE; wave < NUMBER_OF_WAVE; wave++) {
-		generate(&parameter[wave], initialFrequency, samplingTime, &timeSeries[wave]);
+/**
+ * Generates the wave with SpinQuadTaylor, the series point into the LAL time series kept in the handle.
+ */
+static int generateLAL(const Wave *wave, double initialFrequency, double samplingTime, WaveSeries *series) {
+	TimeSeries *timeSeries = calloc(1, sizeof(TimeSeries));
+	int failure = generate(wave, initialFrequency, samplingTime, timeSeries);
+	series->handle = timeSeries;
+	series->length = timeSeries->h[HP] ? timeSeries->h[HP]->data->length : 0;
+	if (failure || !series->length) {
+		return (FAILURE);
 	}
-	Variable *variable = createOutput(timeSeries);
-	fillOutput(timeSeries, variable);
-	for (int wave = FIRST_WAVE; wave < NUMBER_OF_WAVE; wave++) {
-		destroyTimeSeries(&timeSeries[wave]);
+	for (int component = HP; component < WAVE; component++) {
+		series->h[component] = timeSeries->h[component]->data->data;
 	}
-	return (variable);
+	series->V = timeSeries->V->data->data;
+	series->Phi = timeSeries->Phi->data->data;
+	for (int dimension = X; dimension < DIMENSION; dimension++) {
+		series->S1[dimension] = timeSeries->S1[dimension]->data->data;
+		series->S2[dimension] = timeSeries->S2[dimension]->data->data;
+		series->E1[dimension] = timeSeries->E1[dimension]->data->data;
+		series->E3[dimension] = timeSeries->E3[dimension]->data->data;
+	}
+	return (SUCCESS);
 }
 
-static void printHeader(FILE *file, Wave parameter[2], Analysed *analysed) {
-	double M[NUMBER_OF_WAVE] = {
-	    parameter[FIRST_WAVE].binary.mass[0] + parameter[FIRST_WAVE].binary.mass[1],
-	    parameter[SECOND_WAVE].binary.mass[0] + parameter[SECOND_WAVE].binary.mass[1] };
-	double eta[NUMBER_OF_WAVE] = { parameter[FIRST_WAVE].binary.mass[0] * parameter[FIRST_WAVE].binary.mass[1]
-	        / square(M[FIRST_WAVE]), parameter[SECOND_WAVE].binary.mass[0] * parameter[SECOND_WAVE].binary.mass[1]
-	        / square(M[SECOND_WAVE]) };
-	for (int wave = FIRST_WAVE; wave < NUMBER_OF_WAVE; wave++) {
-		fprintf(file, "#%d mass  [m1,m2,M,eta] %11.5g %11.5g %11.5g %11.5g\n", wave, parameter[wave].binary.mass[0],
-		        parameter[wave].binary.mass[1], M[wave], eta[wave]);
+/**
+ * Destroys the LAL time series of the handle.
+ */
+static void releaseLAL(WaveSeries *series) {
+	if (series->handle) {
+		destroyTimeSeries(series->handle);
+		free(series->handle);
 	}
-	for (int blackhole = 0; blackhole < BH; blackhole++) {
-		for (int wave = FIRST_WAVE; wave < NUMBER_OF_WAVE; wave++) {
-			fprintf(file, "#%d spin%d [mag,inc,azi] %11.5g %11.5g %11.5g\n", wave, blackhole,
-			        parameter[wave].binary.spin.magnitude[blackhole],
-			        degreeFromRadian(parameter[wave].binary.spin.inclination[blackhole]),
-			        degreeFromRadian(parameter[wave].binary.spin.azimuth[blackhole]));
+	memset(series, 0, sizeof(WaveSeries));
+}
+
+const GeneratorBackend lalGenerator = { "lal", generateLAL, releaseLAL };
+
+/** Backends in the order of GeneratorKind. */
+static const GeneratorBackend *backend[NUMBER_OF_GENERATOR] = { &lalGenerator, &chirpGenerator };
+
+int generateWave(Wave *wave, double initialFrequency, double samplingTime, WaveSeries *series) {
+	memset(series, 0, sizeof(WaveSeries));
+	convertSpinFromAnglesToXyz(&wave->binary.spin, wave->binary.inclination);
+	return (backend[wave->method.generator]->generate(wave, initialFrequency, samplingTime, series));
+}
+
+void releaseWave(const Wave *wave, WaveSeries *series) {
+	backend[wave->method.generator]->release(series);
+}
+
+int findGenerator(const char *name, GeneratorKind *generator) {
+	for (int kind = LAL_GENERATOR; kind < NUMBER_OF_GENERATOR; kind++) {
+		if (!strcmp(name, backend[kind]->name)) {
+			*generator = kind;
+			return (SUCCESS);
 		}
 	}
-	for (int wave = FIRST_WAVE; wave < NUMBER_OF_WAVE; wave++) {
-		fprintf(file, "#%d method[int, pn,amp] %11s %11d %11d\n", wave, parameter[wave].method.spin,
-		        parameter[wave].method.phase, parameter[wave].method.amplitude);
-	}
-	fprintf(file, "#  match [typ,max,min] %11.5g %11.5g %11.5g\n", analysed->match[TYPICAL], analysed->match[BEST],
-	        analysed->match[WORST]);
-	fprintf(file, "#  period[ 1., 2.,rel] %11d %11d %11.5g\n", analysed->period[FIRST_WAVE],
-	        analysed->period[SECOND_WAVE], analysed->relativePeriod);
-	fprintf(file, "#  length[ 1., 2.,rel] %11.5g %11.5g %11.5g\n", analysed->length[FIRST_WAVE],
-	        analysed->length[SECOND_WAVE], analysed->relativeLength);
+	return (FAILURE);
 }
 
-void printSpins(FILE *file, Variable variable[2], Wave *wave, Analysed *analysed, double samplingTime) {
-	printHeader(file, wave, analysed);
-	fprintf(file, "#%10.5s ", "t");
-	fprintf(file, "%11.5s %11.5s %11.5s ", "1s1x", "1s1y", "1s1z");
-	fprintf(file, "%11.5s %11.5s %11.5s ", "2s1x", "2s1y", "2s1z");
-	fprintf(file, "%11.5s %11.5s %11.5s ", "1s2x", "1s2y", "1s2z");
-	fprintf(file, "%11.5s %11.5s %11.5s\n", "2s2x", "2s2y", "2s2z");
-	int shorter = variable->length[FIRST_WAVE] < variable->length[SECOND_WAVE] ? FIRST_WAVE : SECOND_WAVE;
-	for (size_t index = 0; index < variable->length[shorter]; index++) {
-		fprintf(file, "% 11.5g ", index * samplingTime);
-		fprintf(file, "% 11.5g % 11.5g % 11.5g ", variable->S1[FIRST_WAVE][X][index],
-		        variable->S1[FIRST_WAVE][Y][index], variable->S1[FIRST_WAVE][Z][index]);
-		fprintf(file, "% 11.5g % 11.5g % 11.5g ", variable->S1[SECOND_WAVE][X][index],
-		        variable->S1[SECOND_WAVE][Y][index], variable->S1[SECOND_WAVE][Z][index]);
-		fprintf(file, "% 11.5g % 11.5g % 11.5g ", variable->S2[FIRST_WAVE][X][index],
-		        variable->S2[FIRST_WAVE][Y][index], variable->S2[FIRST_WAVE][Z][index]);
-		fprintf(file, "% 11.5g % 11.5g % 11.5g\n", variable->S2[SECOND_WAVE][X][index],
-		        variable->S2[SECOND_WAVE][Y][index], variable->S2[SECOND_WAVE][Z][index]);
-	}
+const char *getGeneratorName(GeneratorKind generator) {
+	return (backend[generator]->name);
 }
 
-void printSystem(FILE *file, Variable variable[2], Wave *wave, Analysed *analysed, double samplingTime) {
-	printHeader(file, wave, analysed);
-	fprintf(file, "#%10.5s ", "t");
-	fprintf(file, "%11.5s %11.5s %11.5s ", "1e1x", "1e1y", "1e1z");
-	fprintf(file, "%11.5s %11.5s %11.5s ", "2e1x", "2e1y", "2e1z");
-	fprintf(file, "%11.5s %11.5s %11.5s ", "1e3x", "1e3y", "1e3z");
-	fprintf(file, "%11.5s %11.5s %11.5s\n", "2e3x", "2e3y", "2e3z");
-	int shorter = variable->length[FIRST_WAVE] < variable->length[SECOND_WAVE] ? FIRST_WAVE : SECOND_WAVE;
-	for (size_t index = 0; index < variable->length[shorter]; index++) {
-		fprintf(file, "% 11.5g ", index * samplingTime);
-		fprintf(file, "% 11.5g % 11.5g % 11.5g ", variable->E1[FIRST_WAVE][X][index],
-		        variable->E1[FIRST_WAVE][Y][index], variable->E1[FIRST_WAVE][Z][index]);
-		fprintf(file, "% 11.5g % 11.5g % 11.5g ", variable->E1[SECOND_WAVE][X][index],
-		        variable->E1[SECOND_WAVE][Y][index], variable->E1[SECOND_WAVE][Z][index]);
-		fprintf(file, "% 11.5g % 11.5g % 11.5g ", variable->E3[FIRST_WAVE][X][index],
-		        variable->E3[FIRST_WAVE][Y][index], variable->E3[FIRST_WAVE][Z][index]);
-		fprintf(file, "% 11.5g % 11.5g % 11.5g\n", variable->E3[SECOND_WAVE][X][index],
-		        variable->E3[SECOND_WAVE][Y][index], variable->E3[SECOND_WAVE][Z][index]);
+Variable* generateWaveformPair(Wave parameter[], double initialFrequency, double samplingTime) {
+	WaveSeries series[NUMBER_OF_WAVE];
+	for (int wave = FIRST_WAVE; wave < NUMBER_OF_WAVE; wave++) {
+		uint64_t start = startTiming();
+		if (generateWave(&parameter[wave], initialFrequency, samplingTime, &series[wave])) {
+			fprintf(stderr, "The %s generator failed for wave %d.\n", backend[parameter[wave].method.generator]->name,
+			        wave);
+		}
+		stopTiming(GENERATION_STAGE, series[wave].length, start);
 	}
+	Variable *variable = createOutput(series);
+	uint64_t start = startTiming();
+	fillOutput(series, variable);
+	stopTiming(FILL_STAGE, variable->size, start);
+	for (int wave = FIRST_WAVE; wave < NUMBER_OF_WAVE; wave++) {
+		releaseWave(&parameter[wave], &series[wave]);
+	}
+	return (variable);
 }
 
-int printOutput(FILE *file, Variable variable[2], Wave *wave, Analysed *analysed, double samplingTime) {
-	printHeader(file, wave, analysed);
-	fprintf(file, "#%10s %11s %11s %11s %11s %11s %11s %11s %11s %11s %11s %11s %11s\n", "t", "h1", "h2", "hp1", "hc1",
-	        "hp2", "hc2", "omega1", "omega2", "phi1", "phi2", "phi1(deg)", "phi2(deg)");
-	int shorter = variable->length[FIRST_WAVE] < variable->length[SECOND_WAVE] ? FIRST_WAVE : SECOND_WAVE;
-	for (size_t index = 0; index < variable->length[shorter]; index++) {
-		fprintf(file, "% 11.5g % 11.5g % 11.5g % 11.5g % 11.5g % 11.5g % 11.5g ", index * samplingTime,
-		        variable->wave->H[FIRST_WAVE][index], variable->wave->H[SECOND_WAVE][index],
-		        variable->wave->h[HP1][index], variable->wave->h[HC1][index], variable->wave->h[HP2][index],
-		        variable->wave->h[HC2][index]);
-		fprintf(file, "% 11.5g % 11.5g % 11.5g % 11.5g % 11.5g % 11.5g\n", variable->V[FIRST_WAVE][index],
-		        variable->V[SECOND_WAVE][index], variable->Phi[FIRST_WAVE][index], variable->Phi[SECOND_WAVE][index],
-		        degreeFromRadian(normaliseRadians(variable->Phi[FIRST_WAVE][index])),
-		        degreeFromRadian(normaliseRadians(variable->Phi[SECOND_WAVE][index])));
-	}
-	return (SUCCESS);
+double estimateLength(const Wave *wave, double initialFrequency, double samplingTime) {
+	double totalMass = wave->binary.mass[0] + wave->binary.mass[1];
+	double eta = wave->binary.mass[0] * wave->binary.mass[1] / square(totalMass);
+	double chirpMass = LAL_MTSUN_SI * totalMass * pow(eta, 3.0 / 5.0);
+	double duration = 5.0 / 256.0 * pow(LAL_PI * initialFrequency, -8.0 / 3.0) * pow(chirpMass, -5.0 / 3.0);
+	return (duration / samplingTime);
+}
+
+/** Number of the length sized arrays in the phases of a pair. */
+enum {
+	LAL_SERIES = NUMBER_OF_WAVE * (WAVE + 2 + 4 * DIMENSION),
+	VARIABLE_ARRAYS = NUMBER_OF_WAVE * (2 + 4 * DIMENSION),
+	WAVEFORM_ARRAYS = NUMBER_OF_WAVE + COMPONENT,
+	MATCH_ARRAYS = 2 * COMPONENT + 2 + COMPONENT + 1 + 1,
+	LAL_GROWTH = 2,
+};
+
+double estimateMemory(double length) {
+	double generation = LAL_GROWTH * LAL_SERIES + VARIABLE_ARRAYS + WAVEFORM_ARRAYS;
+	double matching = VARIABLE_ARRAYS + WAVEFORM_ARRAYS + MATCH_ARRAYS;
+	return ((generation > matching ? generation : matching) * length * sizeof(double));
 }
@@ -4,11 +4,24 @@
  *	@brief	The main file.
  */
 
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <math.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/dir.h>
 #include <sys/stat.h>
+#include "counters.h"
+#include "critical.h"
+#include "fitting.h"
 #include "generator_lal.h"
+#include "pair_input.h"
+#include "pipeline.h"
+#include "server.h"
+#include "shard.h"
+#include "sink.h"
+#include "timing.h"
 #include "util_IO.h"
 
 static void printConfig(void) {
@@ -17,6 +30,9 @@ static void printConfig(void) {
 			"units {	angle = \"degree\" mass = \"solar\" distance = \"Mpc\" }\n"
 			"boundaryFrequency = {30.0, 500.0}\n"
 			"samplingFrequency = 10240.0\n"
+			"format = \"text\"\n"
+			"dump wave { stride = 1 antiAlias = true window = {0.0, 0.0} last = 0.0 }\n"
+			"sink = \"full\"\n"
 			"\n"
 			"wave default {\n"
 			"	binary {\n"
@@ -31,7 +47,7 @@ static void printConfig(void) {
 			"		distance = 1.0\n"
 			"	}\n"
 			"	method {\n"
-			"		spin = \"ALL\" phase = 4 amplitude = 0\n"
+			"		spin = \"ALL\" phase = 4 amplitude = 0 generator = \"lal\"\n"
 			"	}\n"
 			"}\n"
 			"\n"
@@ -78,57 +94,396 @@ static void printConfig(void) {
 	fclose(file);
 }
 
-static void print(Variable *variable, Wave parameter[2], Analysed *analysed, char *name, double samplingTime,
-        string outputDir) {
+/** Command line options. */
+typedef struct {
+	char *input;	///< configuration file.
+	bool merge;	///< merge the shards instead of running.
+	Shard shard;	///< the shard to evaluate.
+	size_t threads;	///< number of the worker threads.
+	double memoryLimit;	///< memory budget of the running jobs in bytes.
+	WriterMode writerMode;	///< how the dumps are written.
+	char *timing;	///< file of the JSON timing report, NULL prints the report to the standard output.
+	char *trace;	///< file of the Chrome trace, NULL if not tracing.
+	bool counters;	///< reports the hardware counters of the kernels.
+	char *pairs;	///< CSV or binary pair file evaluated instead of the pairs of the configuration.
+	char *serve;	///< socket of the server mode, "-" for the standard input, NULL if not serving.
+	size_t samples;	///< number of the random pairs of the Monte-Carlo sweep, 0 steps the variables.
+	uint64_t seed;	///< seed of the random pairs.
+	double criticalMatch;	///< threshold of the critical spin search, 0 if not searching.
+	double spinTolerance;	///< width of the bracket of the critical spin.
+	size_t fittingRestarts;	///< number of the restarts of the fitting factor search, 0 if not searching.
+	size_t fittingEvaluations;	///< maximal number of the evaluations of a restart.
+	size_t benchmark;	///< number of the random pairs of the generation benchmark, 0 if not benchmarking.
+	bool benchmarkMatch;	///< the generation benchmark measures the matching, too.
+	Antenna *antenna;	///< detector orientations of the projected matches of the exact pairs.
+	size_t antennas;	///< number of the orientations.
+	Detector *detector;	///< detectors of the network match of the exact pairs.
+	size_t detectors;	///< number of the detectors.
+} Arguments;
+
+typedef enum {
+	MASS, MAGNITUDE, INCLINATION, AZIMUTH, NUMBER_OF_VARIABLE, RANDOM_SAMPLE,
+} Value;
+
+/** A point of the run: an exact pair or a point of the statistic. */
+typedef struct {
+	Wave pair[NUMBER_OF_WAVE];	///< parameters of the waves.
+	double value[THIRD];	///< values of the stepped variable.
+	Value variable;	///< the stepped variable, NUMBER_OF_VARIABLE for an exact pair, RANDOM_SAMPLE for a random one.
+	size_t file;	///< index of the output file or of the exact pair.
+	const Parameter *parameter;	///< band and sampling of the point.
+	Analysed analysed;	///< results of the point.
+	double *projected;	///< matches of the detector orientations of an exact pair, in the buffer of the run.
+	double network;	///< network match of an exact pair.
+} Point;
+
+/** Points of a run. */
+typedef struct {
+	const JobPlan *plan;	///< the parsed configuration, shared read-only by the workers.
+	const Parameter *parameter;	///< parameters of the run.
+	const PairJob *exact;	///< the exact pairs, of the plan or of the streamed chunk.
+	char *outputDir;	///< output directory.
+	Point *point;	///< the points.
+	size_t length;	///< number of the points.
+	FILE **file;	///< output files of the statistic.
+	Sink *sink;	///< destination of the exact pairs.
+	const Antenna *antenna;	///< detector orientations of the projected matches.
+	size_t antennas;	///< number of the orientations, 0 if not projecting.
+	FILE *projected;	///< output of the projected matches.
+	const Detector *detector;	///< detectors of the network match.
+	size_t detectors;	///< number of the detectors, 0 if not computing the network match.
+	FILE *network;	///< output of the network matches.
+} Run;
+
+static void addPoint(Run *run, const Wave pair[], double value[], Value variable, size_t file,
+        const Parameter *parameter) {
+	run->point = realloc(run->point, (run->length + 1) * sizeof(Point));
+	Point *point = &run->point[run->length++];
+	memcpy(point->pair, pair, NUMBER_OF_WAVE * sizeof(Wave));
+	point->parameter = parameter;
+	point->value[FIRST] = value ? value[FIRST] : 0.0;
+	point->value[SECOND] = value ? value[SECOND] : 0.0;
+	point->variable = variable;
+	point->file = file;
+	point->projected = NULL;
+}
+
+/**
+ * Estimates the cost and the peak memory of a point from the length of its longer wave.
+ * @param[in]  pair      parameters of the waves.
+ * @param[in]  parameter parameters of the run.
+ * @param[out] cost      estimated cost.
+ * @param[out] memory    predicted peak memory.
+ */
+static void estimatePair(Wave pair[], const Parameter *parameter, double *cost, double *memory) {
+	double length[NUMBER_OF_WAVE];
+	for (int wave = FIRST_WAVE; wave < NUMBER_OF_WAVE; wave++) {
+		length[wave] = estimateLength(&pair[wave], parameter->initialFrequency, parameter->samplingTime);
+	}
+	*cost = length[FIRST_WAVE] > length[SECOND_WAVE] ? length[FIRST_WAVE] : length[SECOND_WAVE];
+	*memory = estimateMemory(*cost);
+}
+
+static void *generatePoint(size_t job, void *context) {
+	Run *run = context;
+	setTraceJob(job, run->point[job].pair[FIRST_WAVE].binary.mass);
+	return (generateWaveformPair(run->point[job].pair, run->point[job].parameter->initialFrequency,
+	        run->point[job].parameter->samplingTime));
+}
+
+static void analysePoint(size_t job, void *item, void *context) {
+	Run *run = context;
+	Variable *variable = item;
+	const Parameter *parameter = run->point[job].parameter;
+	size_t minIndex, maxIndex;
+	setTraceJob(job, run->point[job].pair[FIRST_WAVE].binary.mass);
+	initMatch(variable->wave);
+	generatePSD(parameter->initialFrequency, parameter->samplingFrequency);
+	indexFromFrequency(parameter->initialFrequency, parameter->endingFrequency,
+	        parameter->samplingFrequency / variable->size, &minIndex, &maxIndex);
+	if (run->point[job].projected) {
+		calcProjectedMatches(minIndex, maxIndex, run->antennas, run->antenna, run->point[job].projected);
+	}
+	if (run->detectors && run->point[job].variable == NUMBER_OF_VARIABLE) {
+		run->point[job].network = calcNetworkMatch(minIndex, maxIndex, parameter->initialFrequency,
+		        parameter->samplingFrequency, run->detectors, run->detector);
+	}
+	calcMatches(minIndex, maxIndex, &run->point[job].analysed);
+	countPeriods(parameter->samplingTime, &run->point[job].analysed);
+	cleanMatch();
+}
+
+static void writePoint(size_t job, void *item, void *context) {
+	Run *run = context;
+	Point *point = &run->point[job];
+	Variable *variable = item;
+	setTraceJob(job, point->pair[FIRST_WAVE].binary.mass);
+	if (point->variable == NUMBER_OF_VARIABLE && run->sink->dump) {
+		uint64_t start = startTiming();
+		run->sink->dump(run->sink, run->exact[point->file].name, variable, point->pair,
+		        &point->analysed);
+		stopTiming(OUTPUT_STAGE, variable->size, start);
+	}
+	destroyWaveform(&variable->wave);
+	destroyOutput(&variable);
+}
+
+static void printPoint(FILE *file, Point *point);
+
+static void emitPoint(size_t job, void *context) {
+	Run *run = context;
+	Point *point = &run->point[job];
+	if (point->variable == NUMBER_OF_VARIABLE) {
+		Analysed *analysed = &point->analysed;
+		if (run->sink->report) {
+			run->sink->report(run->sink, run->exact[point->file].name, analysed);
+		}
+		if (run->sink->summarise) {
+			run->sink->summarise(run->sink, run->exact[point->file].name, analysed);
+		}
+		for (size_t current = 0; point->projected && current < run->antennas; current++) {
+			double row[] = { run->antenna[current].plus, run->antenna[current].cross, point->projected[current] };
+			fprintf(run->projected, "%20s %5zu ", run->exact[point->file].name, current);
+			printDoubles(run->projected, row, sizeof(row) / sizeof(row[0]), &rowFormat, '\n');
+		}
+		if (run->network) {
+			fprintf(run->network, "%20s ", run->exact[point->file].name);
+			printDoubles(run->network, &point->network, 1, &rowFormat, '\n');
+		}
+	} else {
+		printPoint(run->file[point->file], point);
+	}
+}
+
+/**
+ * Evaluates the points of the run: the generators, the analysers and the writer work overlapped, the
+ * summaries and the rows of the statistic are emitted in the order of the points. The projected
+ * matches of the exact pairs are kept in one buffer of the run.
+ * @param[in] run       the points.
+ * @param[in] arguments command line options.
+ * @return failure code
+ */
+static int runPoints(Run *run, Arguments *arguments) {
+	static const Stages stages = { generatePoint, analysePoint, writePoint, emitPoint };
+	double *projected = NULL;
+	if (run->antennas && run->length) {
+		projected = malloc(run->length * run->antennas * sizeof(double));
+		if (!projected) {
+			fprintf(stderr, "Couldn't allocate the projected matches of %zu pairs.\n", run->length);
+			return (FAILURE);
+		}
+		for (size_t point = 0; point < run->length; point++) {
+			bool exact = run->point[point].variable == NUMBER_OF_VARIABLE;
+			run->point[point].projected = exact ? &projected[point * run->antennas] : NULL;
+		}
+	}
+	double *cost = calloc(run->length + 1, sizeof(double));
+	double *memory = calloc(run->length + 1, sizeof(double));
+	for (size_t point = 0; point < run->length; point++) {
+		estimatePair(run->point[point].pair, run->point[point].parameter, &cost[point], &memory[point]);
+	}
+	JobEstimate estimate = { cost, memory, arguments->memoryLimit };
+	int failure = runPipeline(run->length, &estimate, arguments->threads, &stages, run);
+	free(cost);
+	free(memory);
+	free(projected);
+	return (failure);
+}
+
+/**
+ * Opens projected.data if detector orientations were given and network.data if detectors were given,
+ * their matches are computed for the exact pairs.
+ * @param[in,out] run       the run of the exact pairs.
+ * @param[in]     arguments command line options.
+ */
+static void openDetectorOutputs(Run *run, Arguments *arguments) {
 	string path;
-	FILE *file;
-	sprintf(path, "%s/%s_spin.data", outputDir, name);
-	file = safelyOpenForWriting(path);
-	printSpins(file, variable, parameter, analysed, samplingTime);
-	fclose(file);
-	sprintf(path, "%s/%s_system.data", outputDir, name);
-	file = safelyOpenForWriting(path);
-	printSystem(file, variable, parameter, analysed, samplingTime);
-	fclose(file);
-	sprintf(path, "%s/%s_wave.data", outputDir, name);
-	file = safelyOpenForWriting(path);
-	printOutput(file, variable, parameter, analysed, samplingTime);
+	if (arguments->antennas) {
+		run->antenna = arguments->antenna;
+		run->antennas = arguments->antennas;
+		sprintf(path, "%s/projected.data", run->outputDir);
+		printf("%s\n", path);
+		run->projected = safelyOpenForWriting(path);
+		fprintf(run->projected, "#%19s %5s %11s %11s %11s\n", "name", "index", "F+", "Fx", "match");
+	}
+	if (arguments->detectors) {
+		run->detector = arguments->detector;
+		run->detectors = arguments->detectors;
+		sprintf(path, "%s/network.data", run->outputDir);
+		printf("%s\n", path);
+		run->network = safelyOpenForWriting(path);
+		fputs("#detectors", run->network);
+		for (size_t current = 0; current < run->detectors; current++) {
+			fprintf(run->network, " %s(%g,%g)", getSiteName(run->detector[current].site),
+			        run->detector[current].antenna.plus, run->detector[current].antenna.cross);
+		}
+		fprintf(run->network, "\n#%19s %11s\n", "name", "match");
+	}
+}
+
+/**
+ * Closes the files opened by openDetectorOutputs.
+ * @param[in,out] run the run of the exact pairs.
+ */
+static void closeDetectorOutputs(Run *run) {
+	if (run->projected) {
+		fclose(run->projected);
+		run->projected = NULL;
+	}
+	if (run->network) {
+		fclose(run->network);
+		run->network = NULL;
+	}
+}
+
+/**
+ * Reads the detector orientations, a line is either "F+ Fx" or "ra dec psi gmst" in degrees.
+ * @param[in]  path    path of the file.
+ * @param[out] antenna the orientations.
+ * @param[out] count   number of the orientations.
+ * @return failure code
+ */
+static int readAntennas(const char *path, Antenna **antenna, size_t *count) {
+	FILE *file = fopen(path, "r");
+	if (!file) {
+		fprintf(stderr, "Couldn't open file %s for reading; %s\n", path, strerror(errno));
+		return (FAILURE);
+	}
+	char line[STRING_LENGTH];
+	size_t number = 0;
+	int failure = SUCCESS;
+	*count = 0;
+	while (!failure && fgets(line, STRING_LENGTH, file)) {
+		number++;
+		double value[4];
+		int read = sscanf(line, "%lf %lf %lf %lf", &value[0], &value[1], &value[2], &value[3]);
+		if (read <= 0) {
+			continue;
+		}
+		*antenna = realloc(*antenna, (*count + 1) * sizeof(Antenna));
+		Antenna *current = &(*antenna)[(*count)++];
+		if (read == 2) {
+			current->plus = value[0];
+			current->cross = value[1];
+		} else if (read == 4) {
+			antennaFromSky(radianFromDegree(value[0]), radianFromDegree(value[1]), radianFromDegree(value[2]),
+			        radianFromDegree(value[3]), current);
+		} else {
+			fprintf(stderr, "Malformed orientation in %s at line %zu.\n", path, number);
+			failure = FAILURE;
+		}
+	}
 	fclose(file);
+	return (failure);
 }
 
-static int generateWaveforms(char *input, Parameter *parameter, string outputDir) {
+/**
+ * Reads the detectors of the network, a line is "site F+ Fx" or "site ra dec psi gmst" in degrees,
+ * the site is H1, L1, V1 or K1.
+ * @param[in]  path     path of the file.
+ * @param[out] detector the detectors.
+ * @param[out] count    number of the detectors.
+ * @return failure code
+ */
+static int readDetectors(const char *path, Detector **detector, size_t *count) {
+	FILE *file = fopen(path, "r");
+	if (!file) {
+		fprintf(stderr, "Couldn't open file %s for reading; %s\n", path, strerror(errno));
+		return (FAILURE);
+	}
+	char line[STRING_LENGTH];
+	size_t number = 0;
 	int failure = SUCCESS;
-	failure &= parseWaves(input, parameter);
-	size_t minIndex, maxIndex;
-	if (!failure) {
-		Variable * variable;
-		for (size_t index = 0; index < parameter->exact->length; index++) {
-			variable = generateWaveformPair(&parameter->exact->wave[2 * index], parameter->initialFrequency,
-			        parameter->samplingTime);
-			initMatch(variable->wave);
-			generatePSD(parameter->initialFrequency, parameter->samplingFrequency);
-			indexFromFrequency(parameter->initialFrequency, parameter->endingFrequency,
-			        parameter->samplingFrequency / variable->size, &minIndex, &maxIndex);
-			Analysed analysed;
-			calcMatches(minIndex, maxIndex, &analysed);
-			countPeriods(parameter->samplingTime, &analysed);
-			printf("w:%g t:%g b:%g\n%d %d %g%%\n%g %g %g%%\n", analysed.match[WORST], analysed.match[TYPICAL],
-			        analysed.match[BEST], analysed.period[FIRST_WAVE], analysed.period[SECOND_WAVE],
-			        analysed.relativePeriod * 100.0, analysed.length[FIRST_WAVE], analysed.length[SECOND_WAVE],
-			        analysed.relativeLength * 100.0);
-			print(variable, &parameter->exact->wave[2 * index], &analysed, parameter->exact->name[index],
-			        parameter->samplingTime, outputDir);
-			cleanMatch();
-			destroyWaveform(&variable->wave);
-			destroyOutput(&variable);
+	*count = 0;
+	while (!failure && fgets(line, STRING_LENGTH, file)) {
+		number++;
+		char name[STRING_LENGTH];
+		double value[4];
+		int read = sscanf(line, "%s %lf %lf %lf %lf", name, &value[0], &value[1], &value[2], &value[3]);
+		if (read <= 0 || *name == '#') {
+			continue;
+		}
+		DetectorSite site = HANFORD;
+		while (site < NUMBER_OF_SITE && strcmp(name, getSiteName(site))) {
+			site++;
+		}
+		if (site == NUMBER_OF_SITE || (read != 3 && read != 5)) {
+			fprintf(stderr, "Malformed detector in %s at line %zu.\n", path, number);
+			failure = FAILURE;
+			continue;
+		}
+		*detector = realloc(*detector, (*count + 1) * sizeof(Detector));
+		Detector *current = &(*detector)[(*count)++];
+		current->site = site;
+		if (read == 3) {
+			current->antenna.plus = value[0];
+			current->antenna.cross = value[1];
+		} else {
+			siteAntennaFromSky(site, radianFromDegree(value[0]), radianFromDegree(value[1]),
+			        radianFromDegree(value[2]), radianFromDegree(value[3]), &current->antenna);
 		}
 	}
+	fclose(file);
 	return (failure);
 }
 
-typedef enum {
-	MASS, MAGNITUDE, INCLINATION, AZIMUTH, NUMBER_OF_VARIABLE,
-} Value;
+static int generateWaveforms(const JobPlan *plan, string outputDir, Arguments *arguments) {
+	const Parameter *parameter = &plan->parameter;
+	Run run = { .plan = plan, .parameter = parameter, .exact = plan->exact, .outputDir = outputDir,
+	        .sink = openSink(parameter, outputDir, arguments->writerMode) };
+	openDetectorOutputs(&run, arguments);
+	for (size_t index = 0; index < plan->exactLength; index++) {
+		if (isInShard(&arguments->shard, index)) {
+			addPoint(&run, plan->exact[index].pair, NULL, NUMBER_OF_VARIABLE, index, parameter);
+		}
+	}
+	int failure = runPoints(&run, arguments);
+	closeDetectorOutputs(&run);
+	closeSink(&run.sink);
+	free(run.point);
+	return (failure);
+}
+
+/**
+ * Evaluates the pairs of the pair file as exact pairs. The rows are read and run through the pipeline
+ * in chunks of PAIR_CHUNK, so the memory does not depend on the number of the rows.
+ * @param[in] plan       the parsed configuration.
+ * @param[in] outputDir  output directory.
+ * @param[in] arguments  command line options.
+ * @return failure code
+ */
+static int streamPairs(const JobPlan *plan, string outputDir, Arguments *arguments) {
+	PairReader *reader = openPairReader(arguments->pairs);
+	if (!reader) {
+		return (FAILURE);
+	}
+	PairRecord *record = malloc(PAIR_CHUNK * sizeof(PairRecord));
+	PairJob *exact = malloc(PAIR_CHUNK * sizeof(PairJob));
+	Parameter *band = malloc(PAIR_CHUNK * sizeof(Parameter));
+	Run run = { .plan = plan, .parameter = &plan->parameter, .exact = exact, .outputDir = outputDir,
+	        .sink = openSink(&plan->parameter, outputDir, arguments->writerMode) };
+	openDetectorOutputs(&run, arguments);
+	int failure = SUCCESS;
+	size_t count, row = 0;
+	while ((count = readPairRecords(reader, PAIR_CHUNK, record))) {
+		run.length = 0;
+		for (size_t current = 0; current < count; current++, row++) {
+			if (isInShard(&arguments->shard, row)) {
+				fillPairJob(&record[current], plan, &exact[current], &band[current]);
+				addPoint(&run, exact[current].pair, NULL, NUMBER_OF_VARIABLE, current, &band[current]);
+			}
+		}
+		failure |= runPoints(&run, arguments);
+	}
+	failure |= closePairReader(&reader);
+	closeDetectorOutputs(&run);
+	closeSink(&run.sink);
+	free(run.point);
+	free(band);
+	free(exact);
+	free(record);
+	return (failure);
+}
 
 string fileName;
 
@@ -212,78 +567,362 @@ static int printHeader(FILE *file, Wave parameter[], Value variable) {
 	return (SUCCESS);
 }
 
-static int generateStatistic(char *input, Parameter *parameter, string outputDir) {
+static void printPoint(FILE *file, Point *point) {
+	const Analysed *analysed = &point->analysed;
+	if (point->variable == RANDOM_SAMPLE) {
+		const Binary *binary = &point->pair[FIRST_WAVE].binary;
+		double row[] = { binary->mass[FIRST], binary->mass[SECOND], binary->spin.magnitude[FIRST],
+		        binary->spin.magnitude[SECOND], degreeFromRadian(binary->spin.inclination[FIRST]),
+		        degreeFromRadian(binary->spin.inclination[SECOND]), degreeFromRadian(binary->spin.azimuth[FIRST]),
+		        degreeFromRadian(binary->spin.azimuth[SECOND]), analysed->match[WORST], analysed->match[TYPICAL],
+		        analysed->match[BEST], analysed->relativePeriod, analysed->relativeLength };
+		printDoubles(file, row, sizeof(row) / sizeof(row[0]), &rowFormat, '\n');
+		return;
+	}
+	if (point->variable == MASS) {
+		double totalMass = point->value[FIRST] + point->value[SECOND];
+		double mass[] = { totalMass, point->value[FIRST] * point->value[SECOND] / square(totalMass) };
+		printDoubles(file, mass, sizeof(mass) / sizeof(mass[0]), &rowFormat, ' ');
+	}
+	double row[] = { point->value[FIRST], point->value[SECOND], analysed->match[WORST], analysed->match[TYPICAL],
+	        analysed->match[BEST], analysed->relativePeriod, analysed->relativeLength };
+	printDoubles(file, row, sizeof(row) / sizeof(row[0]), &rowFormat, '\n');
+}
+
+static int generateStatistic(const JobPlan *plan, string outputDir, Arguments *arguments) {
 	int failure = SUCCESS;
-	failure &= parseStep(input, parameter);
 	double bounds[MINMAX][NUMBER_OF_VARIABLE][BH];
 	for (int boundary = MIN; boundary < MINMAX; boundary++) {
-		bounds[boundary][MASS][FIRST] = parameter->boundary[boundary].binary.mass[FIRST];
-		bounds[boundary][MASS][SECOND] = parameter->boundary[boundary].binary.mass[SECOND];
-		bounds[boundary][MAGNITUDE][FIRST] = parameter->boundary[boundary].binary.spin.magnitude[FIRST];
-		bounds[boundary][MAGNITUDE][SECOND] = parameter->boundary[boundary].binary.spin.magnitude[SECOND];
-		bounds[boundary][INCLINATION][FIRST] = parameter->boundary[boundary].binary.spin.inclination[FIRST];
-		bounds[boundary][INCLINATION][SECOND] = parameter->boundary[boundary].binary.spin.inclination[SECOND];
-		bounds[boundary][AZIMUTH][FIRST] = parameter->boundary[boundary].binary.spin.azimuth[FIRST];
-		bounds[boundary][AZIMUTH][SECOND] = parameter->boundary[boundary].binary.spin.azimuth[SECOND];
+		bounds[boundary][MASS][FIRST] = plan->boundary[boundary].binary.mass[FIRST];
+		bounds[boundary][MASS][SECOND] = plan->boundary[boundary].binary.mass[SECOND];
+		bounds[boundary][MAGNITUDE][FIRST] = plan->boundary[boundary].binary.spin.magnitude[FIRST];
+		bounds[boundary][MAGNITUDE][SECOND] = plan->boundary[boundary].binary.spin.magnitude[SECOND];
+		bounds[boundary][INCLINATION][FIRST] = plan->boundary[boundary].binary.spin.inclination[FIRST];
+		bounds[boundary][INCLINATION][SECOND] = plan->boundary[boundary].binary.spin.inclination[SECOND];
+		bounds[boundary][AZIMUTH][FIRST] = plan->boundary[boundary].binary.spin.azimuth[FIRST];
+		bounds[boundary][AZIMUTH][SECOND] = plan->boundary[boundary].binary.spin.azimuth[SECOND];
 	}
-	size_t minIndex, maxIndex;
 	Wave pair[NUMBER_OF_WAVE];
-	Variable *generated;
-	FILE *file;
-	for (size_t current = FIRST; current < parameter->step->length; current++) {
-		memcpy(pair, &parameter->step->wave[2 * current], 2 * sizeof(Wave));
+	FILE **file = calloc(plan->stepLength * NUMBER_OF_VARIABLE + 1, sizeof(FILE *));
+	Run run = { .plan = plan, .parameter = &plan->parameter, .exact = plan->exact, .outputDir = outputDir,
+	        .file = file };
+	size_t files = 0;
+	for (size_t current = FIRST; current < plan->stepLength; current++) {
+		memcpy(pair, plan->step[current].pair, 2 * sizeof(Wave));
 		for (int variable = MASS; variable < NUMBER_OF_VARIABLE; variable++) {
-			if (!parameter->gen[variable]) {
+			if (!plan->gen[variable]) {
 				continue;
 			}
 			double value[THIRD] = { bounds[MIN][variable][FIRST], bounds[MIN][variable][SECOND] };
 			double diff[THIRD] = { (bounds[MAX][variable][FIRST] - bounds[MIN][variable][FIRST])
-			        / (parameter->numberOfStep[FIRST] - 1), (bounds[MAX][variable][SECOND]
-			        - bounds[MIN][variable][SECOND]) / (parameter->numberOfStep[SECOND] - 1) };
+			        / (plan->numberOfStep[FIRST] - 1), (bounds[MAX][variable][SECOND]
+			        - bounds[MIN][variable][SECOND]) / (plan->numberOfStep[SECOND] - 1) };
 			set(variable, pair, value);
 			string path;
-			sprintf(path, "%s/%s_%s.data", outputDir, parameter->step->name[current], fileName);
+			sprintf(path, "%s/%s_%s.data", outputDir, plan->step[current].name, fileName);
 			printf("%s\n", path);
-			file = safelyOpenForWriting(path);
-			printHeader(file, pair, variable);
+			file[files] = safelyOpenForWriting(path);
+			printHeader(file[files], pair, variable);
 			if (variable == MASS) {
-				fprintf(file, "#%10s %11s  ", "totalMass", "eta");
+				fprintf(file[files], "#%10s %11s  ", "totalMass", "eta");
 			} else {
-				fprintf(file, "#");
+				fprintf(file[files], "#");
 			}
-			fprintf(file, "%9s1 %10s2 %11s %11s %11s %11s %11s\n", fileName, fileName, "worst", "typical", "best",
-			        "relPeriod", "relLength");
+			fprintf(file[files], "%9s1 %10s2 %11s %11s %11s %11s %11s\n", fileName, fileName, "worst", "typical",
+			        "best", "relPeriod", "relLength");
+			size_t row = 0;
 			while (value[FIRST] < bounds[MAX][variable][FIRST] + diff[FIRST]) {
 				value[SECOND] = bounds[MIN][variable][SECOND];
 				set(variable, pair, value);
 				while (value[SECOND] < bounds[MAX][variable][SECOND] + diff[SECOND]) {
 					set(variable, pair, value);
-					generated = generateWaveformPair(pair, parameter->initialFrequency, parameter->samplingTime);
-					initMatch(generated->wave);
-					generatePSD(parameter->initialFrequency, parameter->samplingFrequency);
-					indexFromFrequency(parameter->initialFrequency, parameter->endingFrequency,
-					        parameter->samplingFrequency / generated->size, &minIndex, &maxIndex);
-					Analysed analysed;
-					calcMatches(minIndex, maxIndex, &analysed);
-					countPeriods(parameter->samplingTime, &analysed);
-					if (variable == MASS) {
-						double totalMass = value[FIRST] + value[SECOND];
-						double eta = value[FIRST] * value[SECOND] / square(totalMass);
-						fprintf(file, "%11.5g %11.5g ", totalMass, eta);
+					if (isInShard(&arguments->shard, row++)) {
+						addPoint(&run, pair, value, variable, files, &plan->parameter);
 					}
-					fprintf(file, "%11.5g %11.5g %11.5g %11.5g %11.5g %11.5g %11.5g\n", value[FIRST], value[SECOND],
-					        analysed.match[WORST], analysed.match[TYPICAL], analysed.match[BEST],
-					        analysed.relativePeriod, analysed.relativeLength);
-					cleanMatch();
-					destroyWaveform(&generated->wave);
-					destroyOutput(&generated);
 					value[SECOND] += diff[SECOND];
 				}
 				value[FIRST] += diff[FIRST];
 			}
-			fclose(file);
+			files++;
 		}
 	}
+	failure |= runPoints(&run, arguments);
+	for (size_t current = 0; current < files; current++) {
+		fclose(file[current]);
+	}
+	free(file);
+	free(run.point);
+	return (failure);
+}
+
+/**
+ * Draws the parameters of the sample uniformly between the bounds of the statistic. The numbers come
+ * from the random stream of the sample, so a sample is the same for every step pair, thread count
+ * and shard.
+ * @param[in]     plan   the parsed configuration.
+ * @param[in]     seed   seed of the run.
+ * @param[in]     sample index of the sample.
+ * @param[in,out] pair   the pair, its binaries are overwritten.
+ */
+static void drawSample(const JobPlan *plan, uint64_t seed, size_t sample, Wave pair[]) {
+	const Binary *min = &plan->boundary[MIN].binary;
+	const Binary *max = &plan->boundary[MAX].binary;
+	RandomStream stream;
+	initializeRandomStream(&stream, seed, sample);
+	double value[NUMBER_OF_VARIABLE][BH];
+	for (int blackhole = FIRST; blackhole < BH; blackhole++) {
+		value[MASS][blackhole] = randomStreamBetween(&stream, min->mass[blackhole], max->mass[blackhole]);
+		value[MAGNITUDE][blackhole] = randomStreamBetween(&stream, min->spin.magnitude[blackhole],
+		        max->spin.magnitude[blackhole]);
+		value[INCLINATION][blackhole] = randomStreamBetween(&stream, min->spin.inclination[blackhole],
+		        max->spin.inclination[blackhole]);
+		value[AZIMUTH][blackhole] = randomStreamBetween(&stream, min->spin.azimuth[blackhole],
+		        max->spin.azimuth[blackhole]);
+	}
+	for (Value variable = MASS; variable < NUMBER_OF_VARIABLE; variable++) {
+		set(variable, pair, value[variable]);
+	}
+}
+
+/**
+ * Evaluates random pairs between the bounds of the statistic for every step pair, the rows go to the
+ * name_random.data files in the order of the samples. The samples are run in chunks of PAIR_CHUNK.
+ * @param[in] plan       the parsed configuration.
+ * @param[in] outputDir  output directory.
+ * @param[in] arguments  command line options.
+ * @return failure code
+ */
+static int generateMonteCarlo(const JobPlan *plan, string outputDir, Arguments *arguments) {
+	FILE **file = calloc(plan->stepLength + 1, sizeof(FILE *));
+	for (size_t current = 0; current < plan->stepLength; current++) {
+		string path;
+		sprintf(path, "%s/%s_random.data", outputDir, plan->step[current].name);
+		printf("%s\n", path);
+		file[current] = safelyOpenForWriting(path);
+		fprintf(file[current], "#seed %" PRIu64 " samples %zu\n", arguments->seed, arguments->samples);
+		for (int wave = FIRST_WAVE; wave < NUMBER_OF_WAVE; wave++) {
+			const Method *method = &plan->step[current].pair[wave].method;
+			fprintf(file[current], "#method[int, pn,amp] %11s %11d %11d\n", method->spin, method->phase,
+			        method->amplitude);
+		}
+		fprintf(file[current], "#%10s %11s %11s %11s %11s %11s %11s %11s %11s %11s %11s %11s %11s\n", "m1", "m2",
+		        "chi1", "chi2", "incl1", "incl2", "azim1", "azim2", "worst", "typical", "best", "relPeriod",
+		        "relLength");
+	}
+	Run run = { .plan = plan, .parameter = &plan->parameter, .exact = plan->exact, .outputDir = outputDir,
+	        .file = file };
+	int failure = SUCCESS;
+	for (size_t first = 0; first < arguments->samples; first += PAIR_CHUNK) {
+		size_t last = first + PAIR_CHUNK < arguments->samples ? first + PAIR_CHUNK : arguments->samples;
+		run.length = 0;
+		for (size_t current = 0; current < plan->stepLength; current++) {
+			for (size_t sample = first; sample < last; sample++) {
+				if (isInShard(&arguments->shard, sample)) {
+					Wave pair[NUMBER_OF_WAVE];
+					memcpy(pair, plan->step[current].pair, sizeof(pair));
+					drawSample(plan, arguments->seed, sample, pair);
+					addPoint(&run, pair, NULL, RANDOM_SAMPLE, current, &plan->parameter);
+				}
+			}
+		}
+		failure |= runPoints(&run, arguments);
+	}
+	for (size_t current = 0; current < plan->stepLength; current++) {
+		fclose(file[current]);
+	}
+	free(file);
+	free(run.point);
+	return (failure);
+}
+
+/**
+ * Searches the critical spin magnitudes of the exact pairs, along the spin of each blackhole, and
+ * writes them to critical_spin.data.
+ * @param[in] plan       the parsed configuration.
+ * @param[in] outputDir  output directory.
+ * @param[in] arguments  command line options.
+ * @return failure code
+ */
+static int findCriticalSpins(const JobPlan *plan, string outputDir, Arguments *arguments) {
+	Engine *engine = createEngine(&plan->parameter);
+	if (!engine) {
+		return (FAILURE);
+	}
+	string path;
+	sprintf(path, "%s/critical_spin.data", outputDir);
+	printf("%s\n", path);
+	FILE *file = safelyOpenForWriting(path);
+	fprintf(file, "#threshold %g tolerance %g\n", arguments->criticalMatch, arguments->spinTolerance);
+	fprintf(file, "#%19s %4s %11s %11s %11s %11s %11s %5s\n", "name", "bh", "magnitude", "low", "high", "lowMatch",
+	        "highMatch", "evals");
+	int failure = SUCCESS;
+	for (size_t index = 0; index < plan->exactLength; index++) {
+		if (!isInShard(&arguments->shard, index)) {
+			continue;
+		}
+		for (int blackhole = FIRST; blackhole < BH; blackhole++) {
+			CriticalSpin critical;
+			if (findCriticalSpin(engine, plan->exact[index].pair, blackhole, arguments->criticalMatch,
+			        arguments->spinTolerance, &critical)) {
+				fprintf(stderr, "Couldn't generate the pairs of %s.\n", plan->exact[index].name);
+				failure = FAILURE;
+				continue;
+			}
+			fprintf(file, "%20s %4d %11.5g %11.5g %11.5g %11.5g %11.5g %5zu\n", plan->exact[index].name, blackhole + 1,
+			        critical.magnitude, critical.bracket[MIN], critical.bracket[MAX], critical.match[MIN],
+			        critical.match[MAX], critical.evaluations);
+		}
+	}
+	fclose(file);
+	destroyEngine(&engine);
+	return (failure);
+}
+
+/**
+ * Fills the bounds of the fitting factor search, the bounds of the statistic if configured, otherwise
+ * half and double of the masses and the full range of the magnitudes of the template.
+ * @param[in]  plan     the parsed configuration.
+ * @param[in]  template the template.
+ * @param[out] option   the bounds are set.
+ */
+static void fillFitBounds(const JobPlan *plan, const Wave *template, FitOption *option) {
+	for (int blackhole = FIRST; blackhole < BH; blackhole++) {
+		int mass = FIT_MASS1 + blackhole, magnitude = FIT_MAGNITUDE1 + blackhole;
+		if (plan->stepTrue) {
+			for (int boundary = MIN; boundary < MINMAX; boundary++) {
+				option->bound[boundary][mass] = plan->boundary[boundary].binary.mass[blackhole];
+				option->bound[boundary][magnitude] = plan->boundary[boundary].binary.spin.magnitude[blackhole];
+			}
+		} else {
+			option->bound[MIN][mass] = 0.5 * template->binary.mass[blackhole];
+			option->bound[MAX][mass] = 2.0 * template->binary.mass[blackhole];
+			option->bound[MIN][magnitude] = 0.0;
+			option->bound[MAX][magnitude] = 1.0;
+		}
+	}
+}
+
+/**
+ * Searches the fitting factors of the exact pairs, the first wave is the target, the second one the
+ * template, and writes them to fitting_factor.data.
+ * @param[in] plan       the parsed configuration.
+ * @param[in] outputDir  output directory.
+ * @param[in] arguments  command line options.
+ * @return failure code
+ */
+static int findFittingFactors(const JobPlan *plan, string outputDir, Arguments *arguments) {
+	string path;
+	sprintf(path, "%s/fitting_factor.data", outputDir);
+	printf("%s\n", path);
+	FILE *file = safelyOpenForWriting(path);
+	fprintf(file, "#restarts %zu evaluations %zu seed %" PRIu64 "\n", arguments->fittingRestarts,
+	        arguments->fittingEvaluations, arguments->seed);
+	fprintf(file, "#%19s %11s %11s %11s %11s %11s %7s %5s %6s\n", "name", "ff", "m1", "m2", "chi1", "chi2",
+	        "restart", "evals", "cached");
+	int failure = SUCCESS;
+	for (size_t index = 0; index < plan->exactLength; index++) {
+		if (!isInShard(&arguments->shard, index)) {
+			continue;
+		}
+		const PairJob *job = &plan->exact[index];
+		FitOption option = { arguments->fittingRestarts, arguments->threads, arguments->fittingEvaluations, 1e-5,
+		        arguments->seed, WORST, { { 0.0 } } };
+		fillFitBounds(plan, &job->pair[SECOND_WAVE], &option);
+		FittingFactor fit;
+		if (findFittingFactor(&plan->parameter, job->pair, &option, &fit)) {
+			fprintf(stderr, "Couldn't generate the target of %s.\n", job->name);
+			failure = FAILURE;
+			continue;
+		}
+		const Binary *binary = &fit.template.binary;
+		fprintf(file, "%20s %11.5g %11.5g %11.5g %11.5g %11.5g %7zu %5zu %6zu\n", job->name, fit.match,
+		        binary->mass[FIRST], binary->mass[SECOND], binary->spin.magnitude[FIRST],
+		        binary->spin.magnitude[SECOND], fit.restart, fit.evaluations, fit.cached);
+	}
+	fclose(file);
+	return (failure);
+}
+
+/**
+ * Prints the median, 95th percentile and maximum of the durations in milliseconds.
+ * @param[in]     name     name of the measured stage.
+ * @param[in,out] duration the durations in nanoseconds, sorted on return.
+ * @param[in]     length   number of the durations.
+ */
+static void printDurations(const char *name, double duration[], size_t length) {
+	double median = getMedian(duration, length);
+	printf("  %-10s median %11.4g ms  p95 %11.4g ms  max %11.4g ms\n", name, median * 1e-6,
+	        getSortedPercentile(duration, length, 0.95) * 1e-6, duration[length - 1] * 1e-6);
+}
+
+/**
+ * Measures the generation of random pairs between the bounds of the statistic for every step pair,
+ * that is for every approximant and spin interaction, and prints the throughput and the durations.
+ * The samples are the ones of the Monte-Carlo sweep, evaluated one after the other, the matching is
+ * measured if requested. The context keeps its plans only while the length of the pairs stays the
+ * same, the random samples mostly differ, so the matching times include the planning like the runs.
+ * @param[in] plan       the parsed configuration.
+ * @param[in] arguments  command line options.
+ * @return failure code
+ */
+static int benchmarkGeneration(const JobPlan *plan, Arguments *arguments) {
+	const Parameter *parameter = &plan->parameter;
+	size_t count = arguments->benchmark;
+	double *generation = malloc(count * sizeof(double));
+	double *matching = malloc(count * sizeof(double));
+	MatchContext *context = arguments->benchmarkMatch ? createMatchContext() : NULL;
+	int failure = SUCCESS;
+	for (size_t current = 0; current < plan->stepLength; current++) {
+		const Wave *method = plan->step[current].pair;
+		double samples = 0.0, generationTotal = 0.0, matchingTotal = 0.0;
+		for (size_t sample = 0; sample < count; sample++) {
+			Wave pair[NUMBER_OF_WAVE];
+			memcpy(pair, method, sizeof(pair));
+			drawSample(plan, arguments->seed, sample, pair);
+			uint64_t start = readClock();
+			Variable *variable = generateWaveformPair(pair, parameter->initialFrequency, parameter->samplingTime);
+			generation[sample] = (double) (readClock() - start);
+			generationTotal += generation[sample];
+			samples += (double) (variable->length[FIRST_WAVE] + variable->length[SECOND_WAVE]);
+			failure |= !variable->length[FIRST_WAVE] || !variable->length[SECOND_WAVE];
+			if (context && variable->length[FIRST_WAVE] && variable->length[SECOND_WAVE]) {
+				Analysed analysed;
+				size_t minIndex, maxIndex;
+				start = readClock();
+				prepareMatch(context, variable->wave);
+				prepareNoise(context, parameter->initialFrequency, parameter->samplingFrequency);
+				indexFromFrequency(parameter->initialFrequency, parameter->endingFrequency,
+				        parameter->samplingFrequency / variable->size, &minIndex, &maxIndex);
+				computeMatches(context, minIndex, maxIndex, &analysed);
+				computePeriods(context, parameter->samplingTime, &analysed);
+				finishMatch(context);
+				matching[sample] = (double) (readClock() - start);
+			} else {
+				matching[sample] = 0.0;
+			}
+			matchingTotal += matching[sample];
+			destroyWaveform(&variable->wave);
+			destroyOutput(&variable);
+		}
+		printf("%s: %s/%d/%d - %s/%d/%d, %zu pairs\n", plan->step[current].name, method[FIRST_WAVE].method.spin,
+		        method[FIRST_WAVE].method.phase, method[FIRST_WAVE].method.amplitude, method[SECOND_WAVE].method.spin,
+		        method[SECOND_WAVE].method.phase, method[SECOND_WAVE].method.amplitude, count);
+		printf("  generation %11.4g waveforms/s %11.4g samples/s\n", 2.0 * (double) count / generationTotal * 1e9,
+		        samples / generationTotal * 1e9);
+		printDurations("generation", generation, count);
+		if (context) {
+			double total = generationTotal + matchingTotal;
+			printf("  with match %11.4g pairs/s     %11.4g samples/s\n", (double) count / total * 1e9,
+			        samples / total * 1e9);
+			printDurations("match", matching, count);
+		}
+	}
+	destroyMatchContext(&context);
+	free(matching);
+	free(generation);
+	if (failure) {
+		fputs("Some pairs couldn't be generated.\n", stderr);
+	}
 	return (failure);
 }
 
@@ -304,6 +943,226 @@ static int initDirectory(string output, string input) {
 	return (SUCCESS);
 }
 
+static void printUsage(const char *program) {
+	printf("Usage: %s [--shard i/N] [--threads N] [--memory-limit SIZE] [--direct-io]\n"
+	        "       [--timing[=FILE]] [--trace FILE] [--counters] [--pairs FILE]\n"
+	        "       [--antenna FILE] [--network FILE] [config]\n", program);
+	printf("       %s --monte-carlo N [--seed S] [options] [config]\n", program);
+	printf("       %s --critical-spin MATCH [--spin-tolerance T] [config]\n", program);
+	printf("       %s --fitting-factor N [--fit-evaluations N] [--seed S] [--threads N] [config]\n", program);
+	printf("       %s --benchmark-generation N [--benchmark-match] [--seed S] [config]\n", program);
+	printf("       %s --serve PATH [config]\n", program);
+	printf("       %s merge [config]\n", program);
+	puts("  --shard i/N  evaluates only the i-th of N disjoint subsets of the points,");
+	puts("               the output goes to the shard_i_of_N subdirectory.");
+	puts("  --threads N  number of the worker threads, the longest jobs start first.");
+	puts("  --memory-limit SIZE");
+	puts("               memory budget of the running jobs, with K, M, G or T suffix, a job");
+	puts("               starts only if its predicted peak memory fits into the budget.");
+	puts("  --direct-io  writes the dumps bypassing the page cache where the file system allows.");
+	puts("  --timing[=FILE]");
+	puts("               measures the stages of the jobs per waveform length and prints the count,");
+	puts("               total, median, 95th percentile and maximum at exit, or writes them to FILE as JSON.");
+	puts("  --trace FILE records the stages of the jobs per thread and writes them to FILE in the");
+	puts("               Chrome trace format, for chrome://tracing or Perfetto.");
+	puts("  --counters   counts the cycles, instructions, cache and branch misses of the matching");
+	puts("               kernels per frequency bin or sample, if the system allows perf_event_open.");
+	puts("  --pairs FILE evaluates the rows of the CSV or binary pair file instead of the pairs of the");
+	puts("               configuration, in chunks, see pair_input.h for the columns.");
+	puts("  --antenna FILE");
+	puts("               also computes the matches of the detector responses of the exact pairs for the");
+	puts("               orientations of FILE, a line is \"F+ Fx\" or \"ra dec psi gmst\" in degrees for");
+	puts("               LIGO Hanford, into projected.data; the pairs are generated and transformed once.");
+	puts("  --network FILE");
+	puts("               also computes the network match of the exact pairs over the detectors of FILE,");
+	puts("               a line is \"site F+ Fx\" or \"site ra dec psi gmst\" in degrees with the site H1,");
+	puts("               L1, V1 or K1, each with its own noise curve, into network.data.");
+	puts("  --monte-carlo N");
+	puts("               evaluates N random pairs between the bounds of the statistic for every step");
+	puts("               pair instead of stepping the variables, the same for any thread count.");
+	puts("  --seed S     seed of the random pairs, 0 by default.");
+	puts("  --critical-spin MATCH");
+	puts("               bisects the spin magnitude of each blackhole of the exact pairs between its");
+	puts("               configured value and 1 for the crossing of the worst match and MATCH.");
+	puts("  --spin-tolerance T");
+	puts("               width of the final bracket of the critical spin, 0.001 by default.");
+	puts("  --fitting-factor N");
+	puts("               maximises the worst match of the first wave of each exact pair over the masses");
+	puts("               and spin magnitudes of the second one by N Nelder-Mead restarts, in parallel,");
+	puts("               between the bounds of the statistic, into fitting_factor.data.");
+	puts("  --fit-evaluations N");
+	puts("               maximal number of the evaluations of a restart, 300 by default.");
+	puts("  --benchmark-generation N");
+	puts("               generates the first N random pairs of --monte-carlo for every step pair and");
+	puts("               prints the waveforms and samples per second and the durations.");
+	puts("  --benchmark-match");
+	puts("               the generation benchmark measures the matching of the pairs, too.");
+	puts("  --serve PATH answers the pairs requested on the Unix domain socket PATH, or on the standard");
+	puts("               input if PATH is -, keeping the plans and the generated pairs between the");
+	puts("               requests, see server.h for the protocol.");
+	puts("  merge        combines the shard_i_of_N subdirectories into the output directory.");
+}
+
+/**
+ * Parses a memory size with optional K, M, G or T binary suffix.
+ * @param[in]  text   the size.
+ * @param[out] memory the size in bytes.
+ * @return failure code
+ */
+static int parseMemory(const char *text, double *memory) {
+	char *suffix;
+	*memory = strtod(text, &suffix);
+	const char *units = "KMGT";
+	char *unit = *suffix ? strchr(units, *suffix) : NULL;
+	if (unit) {
+		*memory *= (double) (1ul << (10 * (unit - units + 1)));
+		suffix++;
+	}
+	if (*suffix || *memory < 0.0 || suffix == text) {
+		fprintf(stderr, "Invalid memory size \"%s\".\n", text);
+		return (FAILURE);
+	}
+	return (SUCCESS);
+}
+
+static int parseArguments(int argc, char *argv[], Arguments *arguments) {
+	static struct option options[] = { //
+	        { "shard", required_argument, NULL, 's' }, //
+	        { "threads", required_argument, NULL, 't' }, //
+	        { "memory-limit", required_argument, NULL, 'm' }, //
+	        { "direct-io", no_argument, NULL, 'd' }, //
+	        { "timing", optional_argument, NULL, 'T' }, //
+	        { "trace", required_argument, NULL, 'r' }, //
+	        { "counters", no_argument, NULL, 'c' }, //
+	        { "pairs", required_argument, NULL, 'p' }, //
+	        { "serve", required_argument, NULL, 'S' }, //
+	        { "monte-carlo", required_argument, NULL, 'M' }, //
+	        { "seed", required_argument, NULL, 'e' }, //
+	        { "critical-spin", required_argument, NULL, 'C' }, //
+	        { "spin-tolerance", required_argument, NULL, 'o' }, //
+	        { "fitting-factor", required_argument, NULL, 'F' }, //
+	        { "fit-evaluations", required_argument, NULL, 'E' }, //
+	        { "benchmark-generation", required_argument, NULL, 'B' }, //
+	        { "benchmark-match", no_argument, NULL, 'b' }, //
+	        { "antenna", required_argument, NULL, 'a' }, //
+	        { "network", required_argument, NULL, 'n' }, //
+	        { "help", no_argument, NULL, 'h' }, //
+	        { NULL, 0, NULL, 0 } };
+	char *program = argv[0];
+	arguments->input = "test.conf";
+	arguments->merge = false;
+	arguments->shard.index = 0;
+	arguments->shard.count = 1;
+	arguments->threads = defaultThreads();
+	arguments->memoryLimit = 0.0;
+	arguments->writerMode = WRITER_BUFFERED;
+	arguments->timing = NULL;
+	arguments->trace = NULL;
+	arguments->counters = false;
+	arguments->pairs = NULL;
+	arguments->serve = NULL;
+	arguments->samples = 0;
+	arguments->seed = 0;
+	arguments->criticalMatch = 0.0;
+	arguments->spinTolerance = 1e-3;
+	arguments->fittingRestarts = 0;
+	arguments->fittingEvaluations = 300;
+	arguments->benchmark = 0;
+	arguments->benchmarkMatch = false;
+	arguments->antenna = NULL;
+	arguments->antennas = 0;
+	arguments->detector = NULL;
+	arguments->detectors = 0;
+	if (argc > 1 && !strcmp(argv[1], "merge")) {
+		arguments->merge = true;
+		argc--;
+		argv++;
+	}
+	int option;
+	while ((option = getopt_long(argc, argv, "h", options, NULL)) != -1) {
+		switch (option) {
+		case 's':
+			if (parseShard(optarg, &arguments->shard)) {
+				return (FAILURE);
+			}
+			break;
+		case 't':
+			arguments->threads = strtoul(optarg, NULL, 10);
+			if (!arguments->threads) {
+				arguments->threads = 1;
+			}
+			break;
+		case 'm':
+			if (parseMemory(optarg, &arguments->memoryLimit)) {
+				return (FAILURE);
+			}
+			break;
+		case 'd':
+			arguments->writerMode = WRITER_DIRECT;
+			break;
+		case 'T':
+			timingEnabled = true;
+			arguments->timing = optarg;
+			break;
+		case 'r':
+			tracingEnabled = true;
+			arguments->trace = optarg;
+			break;
+		case 'c':
+			countersEnabled = arguments->counters = true;
+			break;
+		case 'p':
+			arguments->pairs = optarg;
+			break;
+		case 'S':
+			arguments->serve = optarg;
+			break;
+		case 'M':
+			arguments->samples = strtoul(optarg, NULL, 10);
+			break;
+		case 'e':
+			arguments->seed = strtoull(optarg, NULL, 10);
+			break;
+		case 'C':
+			arguments->criticalMatch = strtod(optarg, NULL);
+			break;
+		case 'o':
+			arguments->spinTolerance = strtod(optarg, NULL);
+			break;
+		case 'F':
+			arguments->fittingRestarts = strtoul(optarg, NULL, 10);
+			break;
+		case 'E':
+			arguments->fittingEvaluations = strtoul(optarg, NULL, 10);
+			break;
+		case 'B':
+			arguments->benchmark = strtoul(optarg, NULL, 10);
+			break;
+		case 'b':
+			arguments->benchmarkMatch = true;
+			break;
+		case 'a':
+			if (readAntennas(optarg, &arguments->antenna, &arguments->antennas)) {
+				return (FAILURE);
+			}
+			break;
+		case 'n':
+			if (readDetectors(optarg, &arguments->detector, &arguments->detectors)) {
+				return (FAILURE);
+			}
+			break;
+		case 'h':
+		default:
+			printUsage(program);
+			return (FAILURE);
+		}
+	}
+	if (optind < argc) {
+		arguments->input = argv[optind];
+	}
+	return (SUCCESS);
+}
+
 /**
  * Main program function.
  * @param[in] argc number of arguments
@@ -311,22 +1170,81 @@ static int initDirectory(string output, string input) {
  * @return	error code
  */
 int main(int argc, char *argv[]) {
+	Arguments arguments;
+	if (parseArguments(argc, argv, &arguments)) {
+		return (EXIT_FAILURE);
+	}
 	printConfig();
-	char *input = argc > 1 ? argv[1] : "test.conf";
-	Parameter parameter;
-	memset(&parameter, 0, sizeof(Parameter));
+	char *input = arguments.input;
+	JobPlan plan;
+	if (parsePlan(input, &plan)) {
+		cleanPlan(&plan);
+		puts("Error!");
+		return (EXIT_FAILURE);
+	}
 	string outputDir;
-	initParser(input, &parameter, outputDir);
+	strcpy(outputDir, plan.outputDir);
 	initDirectory(outputDir, input);
-	printf("%s\n", outputDir);
 	int failure = SUCCESS;
-	if (parameter.exactTrue) {
-		failure = generateWaveforms(input, &parameter, outputDir);
+	if (arguments.merge) {
+		failure = mergeShards(outputDir);
+		cleanPlan(&plan);
+		puts(failure ? "Error!" : "OK!");
+		return (failure);
+	}
+	if (arguments.serve) {
+		failure = runServer(arguments.serve, &plan);
+		cleanPlan(&plan);
+		return (failure);
+	}
+	if (initShardDirectory(outputDir, sizeof(string), &arguments.shard)) {
+		cleanPlan(&plan);
+		puts("Error!");
+		return (EXIT_FAILURE);
+	}
+	printf("%s\n", outputDir);
+	if (arguments.benchmark) {
+		if (!plan.stepTrue) {
+			fputs("The generation benchmark needs the bounds of the \"step default\" section.\n", stderr);
+		}
+		failure = !plan.stepTrue || benchmarkGeneration(&plan, &arguments);
+		cleanPlan(&plan);
+		puts(failure ? "Error!" : "OK!");
+		return (failure);
+	}
+	if (arguments.criticalMatch > 0.0) {
+		failure = findCriticalSpins(&plan, outputDir, &arguments);
+	} else if (arguments.fittingRestarts) {
+		failure = findFittingFactors(&plan, outputDir, &arguments);
+	} else if (arguments.pairs) {
+		failure = streamPairs(&plan, outputDir, &arguments);
+	} else if (plan.exactTrue) {
+		failure = generateWaveforms(&plan, outputDir, &arguments);
+	}
+	if (plan.stepTrue && arguments.samples) {
+		failure |= generateMonteCarlo(&plan, outputDir, &arguments);
+	} else if (plan.stepTrue) {
+		failure |= generateStatistic(&plan, outputDir, &arguments);
+	}
+	failure |= flushWriters();
+	if (timingEnabled) {
+		if (arguments.timing) {
+			FILE *file = safelyOpenForWriting(arguments.timing);
+			writeTimingJSON(file);
+			fclose(file);
+		} else {
+			printTimingReport(stdout);
+		}
+	}
+	if (tracingEnabled) {
+		failure |= writeTrace(arguments.trace);
 	}
-	if (parameter.stepTrue) {
-		failure |= generateStatistic(input, &parameter, outputDir);
+	if (arguments.counters) {
+		printCounterReport(stdout);
 	}
-	cleanParameter(&parameter);
+	cleanPlan(&plan);
+	free(arguments.antenna);
+	free(arguments.detector);
 	if (!failure) {
 		puts("OK!");
 	} else {
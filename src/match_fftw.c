@@ -6,13 +6,18 @@
 #include <math.h>
 #include <complex.h>
 #include <fftw3.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
 #include <lal/Date.h>
+#include <lal/DetResponse.h>
+#include <lal/LALDetectors.h>
 #include <lal/LALSimNoise.h>
 #include <lal/FrequencySeries.h>
 #include <lal/Units.h>
+#include "counters.h"
 #include "match_fftw.h"
+#include "timing.h"
 #include "util_math.h"
 
 #undef complex
@@ -30,13 +35,16 @@ typedef fftw_complex complex;
  * @param[in] maxIndex ending index
  * @return inner product
  */
-inline static double innerProduct(complex left[], complex right[], double norm[], size_t minIndex, size_t maxIndex) {
+double innerProduct(complex left[], complex right[], double norm[], size_t minIndex, size_t maxIndex) {
+	CounterValues counters;
+	startCounters(&counters);
 	double scalar = 0.;
 	for (size_t i = minIndex; i < maxIndex; i++) {
 		//scalar += (left[i][0] * right[i][0] + left[i][1] * right[i][1]) / norm[i];
 		//scalar += creal(left[i]*(~right[i])) / norm[i];
 		scalar += creal(left[i] * conj(right[i])) / norm[i];
 	}
+	stopCounters(INNER_PRODUCT_KERNEL, maxIndex - minIndex, &counters);
 	return (4.0 * scalar);
 }
 
@@ -88,7 +96,7 @@ inline static void orthogonalise(complex *plus, complex *cross, double *norm, si
  * @param[in]  maxIndex ending index
  * @param[out] out      orthonormalised vector
  */
-static void orthonormalise(complex *plus, complex *cross, double *norm, size_t minIndex, size_t maxIndex, size_t length,
+void orthonormalise(complex *plus, complex *cross, double *norm, size_t minIndex, size_t maxIndex, size_t length,
         complex *out) {
 	normalise(plus, norm, minIndex, maxIndex, length, plus);
 	normalise(cross, norm, minIndex, maxIndex, length, cross);
@@ -106,9 +114,12 @@ static void orthonormalise(complex *plus, complex *cross, double *norm, size_t m
  */
 inline static void crossProduct(complex left[], complex right[], double norm[], size_t minIndex, size_t maxIndex,
         complex out[]) {
+	CounterValues counters;
+	startCounters(&counters);
 	for (size_t i = minIndex; i < maxIndex; i++) {
 		out[i] = 4.0 * left[i] * conj(right[i]) / norm[i];
 	}
+	stopCounters(CROSS_PRODUCT_KERNEL, maxIndex - minIndex, &counters);
 }
 
 enum {
@@ -120,6 +131,8 @@ static void matches(double *product[PRODUCT], size_t size, double *typ, double *
 	double match_typ, max_Typ = 0.0;
 	double match_best, max_Best = 0.0;
 	double match_minimax, max_Minimax = 0.0;
+	CounterValues counters;
+	startCounters(&counters);
 	for (size_t index = 0; index < size; index++) {
 		A = square(product[PP][index]) + square(product[PC][index]);
 		B = square(product[CP][index]) + square(product[CC][index]);
@@ -131,6 +144,7 @@ static void matches(double *product[PRODUCT], size_t size, double *typ, double *
 		match_minimax = sqrt((A + B) / 2. - sqrt(square(A - B) / 4. + square(C)));
 		max_Minimax = max_Minimax > match_minimax ? max_Minimax : match_minimax;
 	}
+	stopCounters(MATCHES_KERNEL, size, &counters);
 	*typ = max_Typ / 2.;
 	*best = max_Best / 2.;
 	*minimax = max_Minimax / 2.;
@@ -166,7 +180,7 @@ void destroyWaveform(Waveform **waveform) {
 	free(*waveform);
 }
 
-typedef struct {
+struct MatchContext {
 	Waveform *wave;
 	fftw_plan plan[COMPONENT];
 	complex *inFrequency[COMPONENT];
@@ -176,9 +190,25 @@ typedef struct {
 	double *norm;
 	size_t length[2];
 	size_t size;
-} Data;
+	double psd[2];	///< initial and sampling frequency of the noise spectrum in norm.
+	double (*noise)(double);	///< the noise curve of setNoiseCurve, NULL for the one of LALSimulation.
+	bool allocated;	///< the buffers and the plans exist.
+	bool keep;	///< finishMatch keeps the buffers, the plans and the noise spectrum.
+	bool transformed;	///< inFrequency holds the untouched spectra of the waveform.
+	bool holdFirst;	///< computeMatches keeps the orthonormalised spectra of the first wave.
+	bool firstReady;	///< inFrequency holds the orthonormalised spectra of the first wave.
+	size_t firstBand[MINMAX];	///< band of the orthonormalisation of the first wave.
+	complex *projection[PRODUCT];	///< the complex correlations of the polarisations of the projection.
+	fftw_plan pplan[PRODUCT];	///< the inverse FFTs of the correlations, in place.
+	double *siteNoise[NUMBER_OF_SITE];	///< noise spectra of the detectors of the network.
+	double siteBand[NUMBER_OF_SITE][2];	///< initial and sampling frequency of the noise spectra.
+};
+
+static __thread MatchContext data;	///< matching data of the calling thread.
 
-Data data;
+bool matchCacheEnabled = false;
+
+static pthread_mutex_t planner = PTHREAD_MUTEX_INITIALIZER;	///< the FFTW planner is not thread safe.
 
 void indexFromFrequency(double min, double max, double step, size_t *minIndex, size_t *maxIndex) {
 	*minIndex = *maxIndex = 0;
@@ -193,70 +223,216 @@ void indexFromFrequency(double min, double max, double step, size_t *minIndex, s
 	}
 }
 
-void generatePSD(double initialFrequency, double samplingFrequency) {
+/**
+ * Fills the noise spectrum.
+ * @param[out] norm              the spectrum.
+ * @param[in]  size              length of the spectrum.
+ * @param[in]  initialFrequency  initial frequency.
+ * @param[in]  samplingFrequency sampling frequency.
+ * @param[in]  noise             the noise curve.
+ */
+static void fillNoise(double *norm, size_t size, double initialFrequency, double samplingFrequency,
+        double (*noise)(double)) {
+	uint64_t start = startTiming();
 	LIGOTimeGPS epoch;
 	XLALGPSSetREAL8(&epoch, 1.0);
-	REAL8FrequencySeries *psd = XLALCreateREAL8FrequencySeries("aLIGO", &epoch, initialFrequency,
-	        samplingFrequency / data.size, &lalSecondUnit, data.size);
-	XLALSimNoisePSD(psd, initialFrequency, XLALSimNoisePSDaLIGOHighFrequency);
-	memcpy(data.norm, psd->data->data, data.size * sizeof(double));
+	REAL8FrequencySeries *psd = XLALCreateREAL8FrequencySeries("noise", &epoch, initialFrequency,
+	        samplingFrequency / size, &lalSecondUnit, size);
+	XLALSimNoisePSD(psd, initialFrequency, noise);
+	memcpy(norm, psd->data->data, size * sizeof(double));
 	XLALDestroyREAL8FrequencySeries(psd);
+	stopTiming(PSD_STAGE, size, start);
 }
 
-void initMatch(Waveform *waveform) {
+/**
+ * Fills the noise spectrum from the curve at the frequencies of the bins, zero below the initial one.
+ * @param[out] norm              the spectrum.
+ * @param[in]  size              length of the spectrum.
+ * @param[in]  initialFrequency  initial frequency.
+ * @param[in]  samplingFrequency sampling frequency.
+ * @param[in]  noise             the noise curve.
+ */
+static void fillCurve(double *norm, size_t size, double initialFrequency, double samplingFrequency,
+        double (*noise)(double)) {
+	uint64_t start = startTiming();
+	double step = samplingFrequency / size;
+	for (size_t index = 0; index < size; index++) {
+		double frequency = index * step;
+		norm[index] = frequency < initialFrequency ? 0.0 : noise(frequency);
+	}
+	stopTiming(PSD_STAGE, size, start);
+}
+
+void setNoiseCurve(MatchContext *context, double (*noise)(double)) {
+	context->noise = noise;
+	context->psd[0] = context->psd[1] = 0.0;
+	context->firstReady = false;
+}
+
+void prepareNoise(MatchContext *context, double initialFrequency, double samplingFrequency) {
+	if (context->keep && context->psd[0] == initialFrequency && context->psd[1] == samplingFrequency) {
+		return;
+	}
+	if (context->noise) {
+		fillCurve(context->norm, context->size, initialFrequency, samplingFrequency, context->noise);
+	} else {
+		fillNoise(context->norm, context->size, initialFrequency, samplingFrequency,
+		        XLALSimNoisePSDaLIGOHighFrequency);
+	}
+	context->firstReady = false;
+	context->psd[0] = initialFrequency;
+	context->psd[1] = samplingFrequency;
+}
+
+/**
+ * Frees the buffers and the plans of the context.
+ */
+static void freeData(MatchContext *context) {
+	pthread_mutex_lock(&planner);
+	for (int wave = HP1; wave < COMPONENT; wave++) {
+		fftw_free(context->inFrequency[wave]);
+		fftw_free(context->correlated[wave]);
+		fftw_destroy_plan(context->plan[wave]);
+		fftw_destroy_plan(context->iplan[wave]);
+	}
+	for (int product = PP; product < PRODUCT && context->projection[product]; product++) {
+		fftw_destroy_plan(context->pplan[product]);
+		fftw_free(context->projection[product]);
+		context->projection[product] = NULL;
+	}
+	pthread_mutex_unlock(&planner);
+	for (DetectorSite site = HANFORD; site < NUMBER_OF_SITE; site++) {
+		fftw_free(context->siteNoise[site]);
+		context->siteNoise[site] = NULL;
+	}
+	fftw_free(context->norm);
+	fftw_free(context->product);
+	context->allocated = false;
+}
+
+void prepareMatch(MatchContext *context, Waveform *waveform) {
+	uint64_t start = startTiming();
 	for (int wave = FIRST_WAVE; wave < NUMBER_OF_WAVE; wave++) {
-		data.length[wave] = waveform->length[wave];
+		context->length[wave] = waveform->length[wave];
+	}
+	if (context->wave != waveform) {
+		context->firstReady = false;
 	}
-	data.wave = waveform;
-	data.size = max(data.length[0], data.length[1]);
-	data.product = fftw_alloc_complex(data.size);
+	context->wave = waveform;
+	context->transformed = false;
+	size_t size = max(context->length[0], context->length[1]);
+	if (context->allocated && context->size == size) {
+		stopTiming(PLAN_STAGE, context->size, start);
+		return;
+	}
+	if (context->allocated) {
+		freeData(context);
+	}
+	context->size = size;
+	context->allocated = true;
+	context->firstReady = false;
+	context->psd[0] = context->psd[1] = 0.0;
+	context->product = fftw_alloc_complex(context->size);
+	pthread_mutex_lock(&planner);
 	for (int wave = HP1; wave < COMPONENT; wave++) {
-		data.inFrequency[wave] = fftw_alloc_complex(data.size);
-		data.plan[wave] = fftw_plan_dft_r2c_1d((int) data.size, data.wave->h[wave], data.inFrequency[wave],
+		context->inFrequency[wave] = fftw_alloc_complex(context->size);
+		context->plan[wave] = fftw_plan_dft_r2c_1d((int) context->size, context->wave->h[wave],
+		        context->inFrequency[wave], FFTW_ESTIMATE);
+		context->correlated[wave] = fftw_alloc_real(context->size);
+		context->iplan[wave] = fftw_plan_dft_c2r_1d((int) context->size, context->product, context->correlated[wave],
 		        FFTW_ESTIMATE);
-		data.correlated[wave] = fftw_alloc_real(data.size);
-		data.iplan[wave] = fftw_plan_dft_c2r_1d((int) data.size, data.product, data.correlated[wave], FFTW_ESTIMATE);
-		memset(data.inFrequency[wave], 0, data.size * sizeof(complex));
-		memset(data.correlated[wave], 0, data.size * sizeof(double));
+		memset(context->inFrequency[wave], 0, context->size * sizeof(complex));
+		memset(context->correlated[wave], 0, context->size * sizeof(double));
 	}
-	memset(data.product, 0, data.size * sizeof(complex));
-	data.norm = fftw_alloc_real(data.size);
-	memset(data.norm, 0, data.size * sizeof(double));
+	pthread_mutex_unlock(&planner);
+	memset(context->product, 0, context->size * sizeof(complex));
+	context->norm = fftw_alloc_real(context->size);
+	memset(context->norm, 0, context->size * sizeof(double));
+	stopTiming(PLAN_STAGE, context->size, start);
 }
 
-void cleanMatch(void) {
-	for (int wave = HP1; wave < COMPONENT; wave++) {
-		fftw_free(data.inFrequency[wave]);
-		fftw_free(data.correlated[wave]);
-		fftw_destroy_plan(data.plan[wave]);
-		fftw_destroy_plan(data.iplan[wave]);
+void finishMatch(MatchContext *context) {
+	context->wave = NULL;
+	context->firstReady = false;
+	if (!context->keep) {
+		freeData(context);
 	}
-	fftw_free(data.norm);
-	fftw_free(data.product);
 }
 
-void calcMatches(size_t minIndex, size_t maxIndex, Analysed *analysed) {
-	for (int wave = HP1; wave < COMPONENT; wave++) {
-		fftw_execute(data.plan[wave]);
+void holdFirstWave(MatchContext *context, bool hold) {
+	context->holdFirst = hold;
+	context->firstReady = false;
+}
+
+/**
+ * Transforms the polarisations of the waveform, unless the spectra are already there, the held first
+ * wave is not transformed again.
+ */
+static void transform(MatchContext *context) {
+	if (context->transformed) {
+		return;
 	}
-	for (int wave = HP1; wave < HP2; wave++) {
-		orthonormalise(data.inFrequency[2 * wave], data.inFrequency[2 * wave + 1], data.norm, minIndex, maxIndex,
-		        data.size, data.inFrequency[2 * wave + 1]);
+	uint64_t start = startTiming();
+	for (int wave = context->firstReady ? HP2 : HP1; wave < COMPONENT; wave++) {
+		fftw_execute_dft_r2c(context->plan[wave], context->wave->h[wave], context->inFrequency[wave]);
 	}
+	stopTiming(FORWARD_STAGE, context->size, start);
+	context->transformed = true;
+}
+
+void computeMatches(MatchContext *context, size_t minIndex, size_t maxIndex, Analysed *analysed) {
+	if (context->firstBand[MIN] != minIndex || context->firstBand[MAX] != maxIndex) {
+		context->firstReady = false;
+	}
+	transform(context);
+	context->transformed = false;
+	uint64_t start;
+	uint64_t product = 0, inverse = 0;
+	start = startTiming();
+	for (int wave = context->firstReady ? SECOND_WAVE : FIRST_WAVE; wave < NUMBER_OF_WAVE; wave++) {
+		orthonormalise(context->inFrequency[2 * wave], context->inFrequency[2 * wave + 1], context->norm, minIndex,
+		        maxIndex, context->size, context->inFrequency[2 * wave + 1]);
+	}
+	context->firstReady = context->holdFirst;
+	context->firstBand[MIN] = minIndex;
+	context->firstBand[MAX] = maxIndex;
 	for (int wave = HP1; wave < COMPONENT; wave++) {
-		memset(data.product, 0, data.size * sizeof(complex));
-		crossProduct(data.inFrequency[wave / 2], data.inFrequency[wave % 2 + 2], data.norm, minIndex, maxIndex,
-		        data.product);
-		fftw_execute(data.iplan[wave]);
+		memset(context->product, 0, context->size * sizeof(complex));
+		crossProduct(context->inFrequency[wave / 2], context->inFrequency[wave % 2 + 2], context->norm, minIndex,
+		        maxIndex, context->product);
+		if (isTiming()) {
+			uint64_t now = readClock();
+			if (tracingEnabled) {
+				traceSpan(getStageName(PRODUCT_STAGE), start, now, context->size);
+			}
+			product += now - start;
+			start = now;
+		}
+		fftw_execute(context->iplan[wave]);
+		if (isTiming()) {
+			uint64_t now = readClock();
+			if (tracingEnabled) {
+				traceSpan(getStageName(INVERSE_STAGE), start, now, context->size);
+			}
+			inverse += now - start;
+			start = now;
+		}
 	}
-	matches(data.correlated, data.size, &analysed->match[TYPICAL], &analysed->match[BEST], &analysed->match[WORST]);
+	if (timingEnabled) {
+		recordDuration(PRODUCT_STAGE, context->size, product);
+		recordDuration(INVERSE_STAGE, context->size, inverse);
+	}
+	start = startTiming();
+	matches(context->correlated, context->size, &analysed->match[TYPICAL], &analysed->match[BEST],
+	        &analysed->match[WORST]);
+	stopTiming(MATCH_STAGE, context->size, start);
 }
 
-void countPeriods(double samplingTime, Analysed *analysed) {
+void computePeriods(MatchContext *context, double samplingTime, Analysed *analysed) {
 	for (ushort wave = FIRST_WAVE; wave < NUMBER_OF_WAVE; wave++) {
 		analysed->period[wave] = 0;
-		for (size_t index = 1; index < data.length[wave]; index++) {
-			double product = data.wave->H[wave][index - 1] * data.wave->H[wave][index];
+		for (size_t index = 1; index < context->length[wave]; index++) {
+			double product = context->wave->H[wave][index - 1] * context->wave->H[wave][index];
 			if (product < 0.0) {
 				analysed->period[wave]++;
 			} else if (product == 0.0) {
@@ -266,10 +442,234 @@ void countPeriods(double samplingTime, Analysed *analysed) {
 		}
 		analysed->period[wave]--;
 		analysed->period[wave] /= 2;
-		analysed->length[wave] = data.length[wave] * samplingTime;
+		analysed->length[wave] = context->length[wave] * samplingTime;
 	}
 	analysed->relativePeriod = fabs((double) analysed->period[FIRST_WAVE] - (double) analysed->period[SECOND_WAVE])
 	        / (double) analysed->period[FIRST_WAVE];
 	analysed->relativeLength = fabs(analysed->length[FIRST_WAVE] - analysed->length[SECOND_WAVE])
 	        / analysed->length[FIRST_WAVE];
 }
+
+/** Properties of the detector sites. */
+static const struct {
+	const char *name;	///< name of the detector.
+	int detector;	///< index of the detector in lalCachedDetectors.
+	double (*noise)(double);	///< design noise curve.
+} site[NUMBER_OF_SITE] = { //
+        { "H1", LAL_LHO_4K_DETECTOR, XLALSimNoisePSDaLIGOHighFrequency }, //
+        { "L1", LAL_LLO_4K_DETECTOR, XLALSimNoisePSDaLIGOHighFrequency }, //
+        { "V1", LAL_VIRGO_DETECTOR, XLALSimNoisePSDAdvVirgo }, //
+        { "K1", LAL_KAGRA_DETECTOR, XLALSimNoisePSDKAGRA }, //
+};
+
+const char *getSiteName(DetectorSite current) {
+	return (site[current].name);
+}
+
+void siteAntennaFromSky(DetectorSite current, double rightAscension, double declination, double polarisation,
+        double gmst, Antenna *antenna) {
+	XLALComputeDetAMResponse(&antenna->plus, &antenna->cross, lalCachedDetectors[site[current].detector].response,
+	        rightAscension, declination, polarisation, gmst);
+}
+
+void antennaFromSky(double rightAscension, double declination, double polarisation, double gmst,
+        Antenna *antenna) {
+	siteAntennaFromSky(HANFORD, rightAscension, declination, polarisation, gmst, antenna);
+}
+
+static void allocateProjection(MatchContext *context) {
+	if (context->projection[PP]) {
+		return;
+	}
+	pthread_mutex_lock(&planner);
+	for (int product = PP; product < PRODUCT; product++) {
+		context->projection[product] = fftw_alloc_complex(context->size);
+		context->pplan[product] = fftw_plan_dft_1d((int) context->size, context->projection[product],
+		        context->projection[product], FFTW_BACKWARD, FFTW_ESTIMATE);
+	}
+	pthread_mutex_unlock(&planner);
+}
+
+/**
+ * Computes the weights of the polarisation pairs in the product of the responses.
+ * @param[in]  antenna the antenna pattern.
+ * @param[out] weight  the weights of PP, PC, CP and CC.
+ */
+static void weighPolarisations(const Antenna *antenna, double weight[PRODUCT]) {
+	weight[PP] = square(antenna->plus);
+	weight[PC] = weight[CP] = antenna->plus * antenna->cross;
+	weight[CC] = square(antenna->cross);
+}
+
+/**
+ * Computes the inner products of the polarisations of the waves.
+ * @param[in]  context  the context.
+ * @param[in]  norm     the noise spectrum.
+ * @param[in]  minIndex starting index
+ * @param[in]  maxIndex ending index
+ * @param[out] product  the inner products of PP, PC, CP and CC per wave.
+ */
+static void normalisePolarisations(MatchContext *context, double *norm, size_t minIndex, size_t maxIndex,
+        double product[NUMBER_OF_WAVE][PRODUCT]) {
+	for (int wave = FIRST_WAVE; wave < NUMBER_OF_WAVE; wave++) {
+		complex *plus = context->inFrequency[2 * wave], *cross = context->inFrequency[2 * wave + 1];
+		product[wave][PP] = innerProduct(plus, plus, norm, minIndex, maxIndex);
+		product[wave][PC] = product[wave][CP] = innerProduct(plus, cross, norm, minIndex, maxIndex);
+		product[wave][CC] = innerProduct(cross, cross, norm, minIndex, maxIndex);
+	}
+}
+
+/**
+ * Computes the complex correlations of the polarisations of the two waves.
+ * \f[
+ * 	x_{ab}(t)=4\sum_f\frac{\tilde{h}_{a,1}(f)\tilde{h}_{b,2}^*(f)}{S_h(f)}e^{2\pi ift}
+ * \f]
+ */
+static void correlatePolarisations(MatchContext *context, size_t minIndex, size_t maxIndex) {
+	allocateProjection(context);
+	for (int product = PP; product < PRODUCT; product++) {
+		memset(context->projection[product], 0, context->size * sizeof(complex));
+		crossProduct(context->inFrequency[HP1 + product / 2], context->inFrequency[HP2 + product % 2],
+		        context->norm, minIndex, maxIndex, context->projection[product]);
+		fftw_execute(context->pplan[product]);
+	}
+}
+
+void computeProjectedMatches(MatchContext *context, size_t minIndex, size_t maxIndex, size_t count,
+        const Antenna antenna[], double match[]) {
+	context->firstReady = false;
+	transform(context);
+	uint64_t start = startTiming();
+	correlatePolarisations(context, minIndex, maxIndex);
+	stopTiming(PRODUCT_STAGE, context->size, start);
+	start = startTiming();
+	double norm[NUMBER_OF_WAVE][PRODUCT];
+	normalisePolarisations(context, context->norm, minIndex, maxIndex, norm);
+	for (size_t current = 0; current < count; current++) {
+		double weight[PRODUCT];
+		weighPolarisations(&antenna[current], weight);
+		double normalisation = 1.0;
+		for (int wave = FIRST_WAVE; wave < NUMBER_OF_WAVE; wave++) {
+			double product = 0.0;
+			for (int pair = PP; pair < PRODUCT; pair++) {
+				product += weight[pair] * norm[wave][pair];
+			}
+			normalisation *= product;
+		}
+		double maximum = 0.0;
+		for (size_t index = 0; index < context->size; index++) {
+			complex correlation = weight[PP] * context->projection[PP][index]
+			        + weight[PC] * (context->projection[PC][index] + context->projection[CP][index])
+			        + weight[CC] * context->projection[CC][index];
+			double value = square(creal(correlation)) + square(cimag(correlation));
+			maximum = maximum > value ? maximum : value;
+		}
+		match[current] = normalisation > 0.0 ? sqrt(maximum / normalisation) : 0.0;
+	}
+	stopTiming(MATCH_STAGE, context->size, start);
+}
+
+double computeNetworkMatch(MatchContext *context, size_t minIndex, size_t maxIndex, double initialFrequency,
+        double samplingFrequency, size_t count, const Detector detector[]) {
+	context->firstReady = false;
+	transform(context);
+	allocateProjection(context);
+	uint64_t start = startTiming();
+	complex *combined = context->projection[PP];
+	memset(combined, 0, context->size * sizeof(complex));
+	double normalisation[NUMBER_OF_WAVE] = { 0.0, 0.0 };
+	for (size_t current = 0; current < count; current++) {
+		DetectorSite at = detector[current].site;
+		if (!context->siteNoise[at] || context->siteBand[at][0] != initialFrequency
+		        || context->siteBand[at][1] != samplingFrequency) {
+			if (!context->siteNoise[at]) {
+				context->siteNoise[at] = fftw_alloc_real(context->size);
+			}
+			fillNoise(context->siteNoise[at], context->size, initialFrequency, samplingFrequency, site[at].noise);
+			context->siteBand[at][0] = initialFrequency;
+			context->siteBand[at][1] = samplingFrequency;
+		}
+		double *norm = context->siteNoise[at];
+		double weight[PRODUCT], product[NUMBER_OF_WAVE][PRODUCT];
+		weighPolarisations(&detector[current].antenna, weight);
+		normalisePolarisations(context, norm, minIndex, maxIndex, product);
+		for (int wave = FIRST_WAVE; wave < NUMBER_OF_WAVE; wave++) {
+			for (int pair = PP; pair < PRODUCT; pair++) {
+				normalisation[wave] += weight[pair] * product[wave][pair];
+			}
+		}
+		complex *plus[NUMBER_OF_WAVE] = { context->inFrequency[HP1], context->inFrequency[HP2] };
+		complex *cross[NUMBER_OF_WAVE] = { context->inFrequency[HC1], context->inFrequency[HC2] };
+		for (size_t index = minIndex; index < maxIndex; index++) {
+			complex first = detector[current].antenna.plus * plus[FIRST_WAVE][index]
+			        + detector[current].antenna.cross * cross[FIRST_WAVE][index];
+			complex second = detector[current].antenna.plus * plus[SECOND_WAVE][index]
+			        + detector[current].antenna.cross * cross[SECOND_WAVE][index];
+			combined[index] += 4.0 * first * conj(second) / norm[index];
+		}
+	}
+	fftw_execute(context->pplan[PP]);
+	stopTiming(PRODUCT_STAGE, context->size, start);
+	start = startTiming();
+	double maximum = 0.0;
+	for (size_t index = 0; index < context->size; index++) {
+		double value = square(creal(combined[index])) + square(cimag(combined[index]));
+		maximum = maximum > value ? maximum : value;
+	}
+	stopTiming(MATCH_STAGE, context->size, start);
+	double product = normalisation[FIRST_WAVE] * normalisation[SECOND_WAVE];
+	return (product > 0.0 ? sqrt(maximum / product) : 0.0);
+}
+
+double calcNetworkMatch(size_t minIndex, size_t maxIndex, double initialFrequency, double samplingFrequency,
+        size_t count, const Detector detector[]) {
+	return (computeNetworkMatch(&data, minIndex, maxIndex, initialFrequency, samplingFrequency, count, detector));
+}
+
+void calcProjectedMatches(size_t minIndex, size_t maxIndex, size_t count, const Antenna antenna[], double match[]) {
+	computeProjectedMatches(&data, minIndex, maxIndex, count, antenna, match);
+}
+
+MatchContext *createMatchContext(void) {
+	MatchContext *context = calloc(1, sizeof(MatchContext));
+	if (context) {
+		context->keep = true;
+	}
+	return (context);
+}
+
+void destroyMatchContext(MatchContext **context) {
+	if (*context && (*context)->allocated) {
+		freeData(*context);
+	}
+	free(*context);
+	*context = NULL;
+}
+
+void generatePSD(double initialFrequency, double samplingFrequency) {
+	prepareNoise(&data, initialFrequency, samplingFrequency);
+}
+
+void initMatch(Waveform *waveform) {
+	data.keep = matchCacheEnabled;
+	prepareMatch(&data, waveform);
+}
+
+void cleanMatch(void) {
+	data.keep = matchCacheEnabled;
+	finishMatch(&data);
+}
+
+void releaseMatchCache(void) {
+	if (data.allocated) {
+		freeData(&data);
+	}
+}
+
+void calcMatches(size_t minIndex, size_t maxIndex, Analysed *analysed) {
+	computeMatches(&data, minIndex, maxIndex, analysed);
+}
+
+void countPeriods(double samplingTime, Analysed *analysed) {
+	computePeriods(&data, samplingTime, analysed);
+}
@@ -0,0 +1,224 @@
+/**	@file   pair_input.c
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Streaming input of the pairs from CSV or binary files.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dump_binary.h"
+#include "pair_input.h"
+
+enum {
+	CSV_COLUMNS = 17,	///< number of the required CSV columns.
+	CSV_BAND = 19,	///< number of the CSV columns with the band.
+	INPUT_BUFFER = 1 << 20,	///< size of the stdio buffer of the file.
+};
+
+struct PairReader {
+	FILE *file;	///< the file.
+	bool binary;	///< the file holds PairRecords.
+	char *line;	///< the current line of the CSV.
+	size_t size;	///< size of the line buffer.
+	size_t number;	///< number of the current line or record.
+	bool started;	///< the first line, the optional header, is read.
+	int failure;	///< FAILURE if a row was malformed.
+	string path;	///< path of the file, for the error messages.
+};
+
+PairReader *openPairReader(const char *path) {
+	FILE *file = fopen(path, "rb");
+	if (!file) {
+		fprintf(stderr, "Couldn't open file %s for reading; %s\n", path, strerror(errno));
+		return (NULL);
+	}
+	PairReader *reader = calloc(1, sizeof(PairReader));
+	reader->file = file;
+	strncpy(reader->path, path, sizeof(string) - 1);
+	setvbuf(file, NULL, _IOFBF, INPUT_BUFFER);
+	PairHeader header;
+	if (fread(&header, sizeof(PairHeader), 1, file) == 1 && !memcmp(header.magic, PAIR_MAGIC, PAIR_MAGIC_LENGTH)) {
+		if (header.version != PAIR_VERSION || header.byteOrder != DUMP_BYTE_ORDER
+		        || header.recordSize != sizeof(PairRecord)) {
+			fprintf(stderr, "Couldn't read file %s; unsupported layout\n", path);
+			fclose(file);
+			free(reader);
+			return (NULL);
+		}
+		reader->binary = true;
+	} else {
+		rewind(file);
+	}
+	return (reader);
+}
+
+/**
+ * Copies the trimmed field into the text.
+ * @param[in]  field the field.
+ * @param[out] text  the text.
+ * @param[in]  size  size of the text.
+ */
+static void copyField(const char *field, char *text, size_t size) {
+	while (*field == ' ' || *field == '\t') {
+		field++;
+	}
+	size_t length = strcspn(field, " \t\r\n");
+	length = length < size - 1 ? length : size - 1;
+	memcpy(text, field, length);
+	text[length] = '\0';
+}
+
+static bool parseNumber(const char *field, double *value) {
+	char *end;
+	*value = strtod(field, &end);
+	while (*end == ' ' || *end == '\t' || *end == '\r' || *end == '\n') {
+		end++;
+	}
+	return (end != field && !*end);
+}
+
+int parsePairLine(char *line, PairRecord *record) {
+	char *field[CSV_BAND];
+	size_t count = 0;
+	char *current = line;
+	for (; current && count < CSV_BAND; count++) {
+		field[count] = current;
+		current = strchr(current, ',');
+		if (current) {
+			*current++ = '\0';
+		}
+	}
+	if (current || (count != CSV_COLUMNS && count != CSV_BAND)) {
+		return (FAILURE);
+	}
+	memset(record, 0, sizeof(PairRecord));
+	copyField(field[0], record->name, PAIR_NAME);
+	double *number[] = { &record->mass[FIRST], &record->mass[SECOND], &record->magnitude[FIRST],
+	        &record->inclination[FIRST], &record->azimuth[FIRST], &record->magnitude[SECOND],
+	        &record->inclination[SECOND], &record->azimuth[SECOND], &record->orbitInclination, &record->distance };
+	int failure = SUCCESS;
+	for (size_t index = 0; index < sizeof(number) / sizeof(number[0]); index++) {
+		failure |= !parseNumber(field[1 + index], number[index]);
+	}
+	for (int wave = FIRST; wave < BH; wave++) {
+		double phase, amplitude;
+		copyField(field[11 + 3 * wave], record->spin[wave], PAIR_SPIN);
+		failure |= !parseNumber(field[12 + 3 * wave], &phase) || !parseNumber(field[13 + 3 * wave], &amplitude);
+		record->phase[wave] = (int32_t) phase;
+		record->amplitude[wave] = (int32_t) amplitude;
+	}
+	if (count == CSV_BAND) {
+		failure |= !parseNumber(field[17], &record->band[MIN]) || !parseNumber(field[18], &record->band[MAX]);
+	}
+	return (failure);
+}
+
+static size_t readLines(PairReader *reader, size_t capacity, PairRecord record[]) {
+	size_t count = 0;
+	while (count < capacity && getline(&reader->line, &reader->size, reader->file) >= 0) {
+		reader->number++;
+		char *line = reader->line + strspn(reader->line, " \t");
+		if (*line == '#' || *line == '\n' || *line == '\r' || !*line) {
+			continue;
+		}
+		bool header = !reader->started && !strncmp(line, "name", 4);
+		reader->started = true;
+		if (header) {
+			continue;
+		}
+		if (parsePairLine(line, &record[count])) {
+			fprintf(stderr, "Malformed pair in %s at line %zu.\n", reader->path, reader->number);
+			reader->failure = FAILURE;
+			break;
+		}
+		count++;
+	}
+	return (count);
+}
+
+size_t readPairRecords(PairReader *reader, size_t capacity, PairRecord record[]) {
+	if (reader->failure) {
+		return (0);
+	}
+	if (!reader->binary) {
+		return (readLines(reader, capacity, record));
+	}
+	size_t count = fread(record, sizeof(PairRecord), capacity, reader->file);
+	reader->number += count;
+	if (count < capacity && ferror(reader->file)) {
+		fprintf(stderr, "Couldn't read file %s; %s\n", reader->path, strerror(errno));
+		reader->failure = FAILURE;
+	}
+	for (size_t current = 0; current < count; current++) {
+		record[current].name[PAIR_NAME - 1] = '\0';
+		record[current].spin[FIRST][PAIR_SPIN - 1] = record[current].spin[SECOND][PAIR_SPIN - 1] = '\0';
+	}
+	return (count);
+}
+
+int closePairReader(PairReader **reader) {
+	int failure = (*reader)->failure;
+	fclose((*reader)->file);
+	free((*reader)->line);
+	free(*reader);
+	*reader = NULL;
+	return (failure);
+}
+
+void fillPairJob(const PairRecord *record, const JobPlan *plan, PairJob *job, Parameter *band) {
+	memset(job, 0, sizeof(PairJob));
+	strncpy(job->name, record->name, STRING_LENGTH - 1);
+	for (int wave = FIRST; wave < BH; wave++) {
+		Wave *current = &job->pair[wave];
+		for (int blackhole = FIRST; blackhole < BH; blackhole++) {
+			current->binary.mass[blackhole] = record->mass[blackhole];
+			current->binary.spin.magnitude[blackhole] = record->magnitude[blackhole];
+			current->binary.spin.inclination[blackhole] = radianFromDegree(record->inclination[blackhole]);
+			current->binary.spin.azimuth[blackhole] = radianFromDegree(record->azimuth[blackhole]);
+		}
+		current->binary.spin.system = PRECESSING;
+		current->binary.inclination = radianFromDegree(record->orbitInclination);
+		current->binary.distance = record->distance;
+		strncpy(current->method.spin, record->spin[wave], STRING_LENGTH - 1);
+		current->method.phase = record->phase[wave];
+		current->method.amplitude = record->amplitude[wave];
+		current->method.generator = plan->defaultWave.method.generator;
+		strncpy(current->name, record->name, STRING_LENGTH - 1);
+	}
+	*band = plan->parameter;
+	if (record->band[MIN] > 0.0) {
+		band->initialFrequency = record->band[MIN];
+	}
+	if (record->band[MAX] > 0.0) {
+		band->endingFrequency = record->band[MAX];
+	}
+}
+
+int convertPairs(const char *input, const char *output) {
+	PairReader *reader = openPairReader(input);
+	if (!reader) {
+		return (FAILURE);
+	}
+	FILE *file = fopen(output, "wb");
+	if (!file) {
+		fprintf(stderr, "Couldn't open file %s for writing; %s\n", output, strerror(errno));
+		closePairReader(&reader);
+		return (FAILURE);
+	}
+	PairHeader header = { PAIR_MAGIC, PAIR_VERSION, DUMP_BYTE_ORDER, sizeof(PairRecord) };
+	int failure = fwrite(&header, sizeof(PairHeader), 1, file) != 1;
+	PairRecord *record = malloc(PAIR_CHUNK * sizeof(PairRecord));
+	size_t count;
+	while (!failure && (count = readPairRecords(reader, PAIR_CHUNK, record))) {
+		failure = fwrite(record, sizeof(PairRecord), count, file) != count;
+	}
+	free(record);
+	failure |= closePairReader(&reader);
+	if (fclose(file) || failure) {
+		fprintf(stderr, "Couldn't convert file %s to %s.\n", input, output);
+		return (FAILURE);
+	}
+	return (SUCCESS);
+}
@@ -5,10 +5,12 @@
  */
 
 #include <confuse.h>
+#include <math.h>
 #include <string.h>
 #include <stdlib.h>
 #include "util_math.h"
 #include "parser_confuse.h"
+#include "test.h"
 
 /** IDs for the names of the options. */
 enum {
@@ -33,6 +35,14 @@ enum {
 	DIFF,
 	GENERATE,
 	STEP,
+	FORMAT,
+	DUMP,
+	STRIDE,
+	ANTI_ALIAS,
+	WINDOW,
+	LAST,
+	SINK,
+	GENERATOR,
 	OPTIONS,
 };
 
@@ -58,18 +68,27 @@ char optionName[OPTIONS][STRING_LENGTH] = {
     "pair",
     "diff",
     "gen",
-    "step" };
+    "step",
+    "format",
+    "dump",
+    "stride",
+    "antiAlias",
+    "window",
+    "last",
+    "sink",
+    "generator" };
 
 enum {
 	UNIT_SIZE = 4,
 	SPIN_SIZE = 5,
 	NUMBER_POSITION = 3,
 	BINARY_SIZE = 5,
-	METHOD_SIZE = 4,
+	METHOD_SIZE = 5,
 	WAVE_SIZE = 3,
 	PAIR_SIZE = 2,
 	STEP_SIZE = 4,
-	OPTION_SIZE = 8,
+	DUMP_SIZE = 5,
+	OPTION_SIZE = 11,
 };
 
 /** Structure containing the options hierarchy. */
@@ -78,13 +97,25 @@ typedef struct {
 	cfg_opt_t spin[SPIN_SIZE];	///< Second spin parameters.
 	cfg_opt_t binary[BINARY_SIZE];	///< Second spin parameters.
 	cfg_opt_t method[METHOD_SIZE];	///< Generation method.
-	cfg_opt_t defaultWave[WAVE_SIZE];	///< Default parameters.
+	cfg_opt_t wave[WAVE_SIZE];	///< Parameters of a wave.
 	cfg_opt_t pair[PAIR_SIZE];	///< Default parameters.
 	cfg_opt_t step[STEP_SIZE];	///< Default parameters.
+	cfg_opt_t dump[DUMP_SIZE];	///< Sample selection of the dumps.
 	cfg_opt_t option[OPTION_SIZE];	///< Group of the unit options.
 } Option;
 
-Wave defaultWave;	///< default wave parameters.
+/** Parameters omitted from the sections titled "default", of the wave and of the bounds. */
+static const Wave sectionDefaults = { //
+        .binary = { .mass = { 3.0, 3.0 }, .spin = { .magnitude = { 1.0, 1.0 }, .system = PRECESSING }, //
+                .inclination = M_PI / 18.0, .distance = 1.0 }, //
+        .method = { "ALL", 4, 0, LAL_GENERATOR }, //
+        .name = "wave" };
+
+/** Parameters of the waves omitted from the configuration without a wave titled "default". */
+static const Wave missingDefaults = { //
+        .binary = { .mass = { 3.0, 3.0 }, .spin = { .system = PRECESSING }, .distance = 1.0 }, //
+        .method = { "ALL", 4, 2, LAL_GENERATOR }, //
+        .name = "wave" };
 
 static int parseFrequency(cfg_t *config, Parameter *parameters) {
 	parameters->initialFrequency = cfg_getnfloat(config, optionName[BOUNDARY_FREQUENCY], 0);
@@ -94,78 +125,93 @@ static int parseFrequency(cfg_t *config, Parameter *parameters) {
 	return (SUCCESS);
 }
 
-static int parseSpin(cfg_t *config, Spin *spin) {
-	for (int blackhole = FIRST; blackhole < BH; blackhole++) {
-		spin->magnitude[blackhole] = cfg_getnfloat(config, optionName[MAGNITUDE], blackhole);
-		spin->inclination[blackhole] = cfg_getnfloat(config, optionName[INCLINATION], blackhole);
-		spin->inclination[blackhole] = radianFromDegree(spin->inclination[blackhole]);
-		spin->azimuth[blackhole] = cfg_getnfloat(config, optionName[AZIMUTH], blackhole);
-		spin->azimuth[blackhole] = radianFromDegree(spin->azimuth[blackhole]);
+/**
+ * Overwrites the value if the option is given, the wave options have no defaults.
+ * @param[in]     config the section.
+ * @param[in]     name   ID of the option.
+ * @param[in]     index  index in the list.
+ * @param[in,out] value  the value.
+ */
+static void resolveFloat(cfg_t *config, int name, unsigned index, double *value) {
+	if (config && cfg_size(config, optionName[name]) > index) {
+		*value = cfg_getnfloat(config, optionName[name], index);
 	}
-	spin->system = PRECESSING;
-	return (SUCCESS);
 }
 
-static int parseGeneration(cfg_t *config, Method *method) {
-	char *spin = cfg_getstr(config, optionName[SPIN]);
-	strcpy(method->spin, spin);
-	method->phase = cfg_getint(config, optionName[PHASE]);
-	method->amplitude = cfg_getint(config, optionName[AMPLITUDE]);
-	return (SUCCESS);
+static void resolveAngle(cfg_t *config, int name, unsigned index, double *value) {
+	if (config && cfg_size(config, optionName[name]) > index) {
+		*value = radianFromDegree(cfg_getnfloat(config, optionName[name], index));
+	}
 }
 
-static int parseBinary(cfg_t *config, Binary *binary) {
-	int failure = SUCCESS;
-	cfg_t *spin = cfg_getsec(config, optionName[SPIN]);
+static void parseSpin(cfg_t *config, Spin *spin) {
 	for (int blackhole = FIRST; blackhole < BH; blackhole++) {
-		binary->mass[blackhole] = cfg_getnfloat(config, optionName[MASS], blackhole);
+		resolveFloat(config, MAGNITUDE, blackhole, &spin->magnitude[blackhole]);
+		resolveAngle(config, INCLINATION, blackhole, &spin->inclination[blackhole]);
+		resolveAngle(config, AZIMUTH, blackhole, &spin->azimuth[blackhole]);
 	}
-	binary->inclination = cfg_getfloat(config, optionName[INCLINATION]);
-	binary->inclination = radianFromDegree(binary->inclination);
-	binary->distance = cfg_getfloat(config, optionName[DISTANCE]);
-	failure = parseSpin(spin, &binary->spin);
-	return (failure);
-}
-
-static int parseWave(cfg_t *config, Wave *parameters) {
-	int failure = SUCCESS;
-	cfg_t *binary = cfg_getsec(config, optionName[BINARY]);
-	failure &= parseBinary(binary, &parameters->binary);
-	cfg_t *generation = cfg_getsec(config, optionName[METHOD]);
-	failure &= parseGeneration(generation, &parameters->method);
-	return (failure);
+	spin->system = PRECESSING;
 }
 
-static WavePair *createWavePair(size_t length) {
-	WavePair *pair = calloc(1, sizeof(WavePair));
-	pair->length = length;
-	pair->wave = calloc(2 * pair->length, sizeof(Wave));
-	pair->name = calloc(pair->length, sizeof(string));
-	return (pair);
+static int parseGeneration(cfg_t *config, Method *method) {
+	if (!config) {
+		return (SUCCESS);
+	}
+	if (cfg_size(config, optionName[SPIN])) {
+		strncpy(method->spin, cfg_getstr(config, optionName[SPIN]), STRING_LENGTH - 1);
+	}
+	if (cfg_size(config, optionName[PHASE])) {
+		method->phase = cfg_getint(config, optionName[PHASE]);
+	}
+	if (cfg_size(config, optionName[AMPLITUDE])) {
+		method->amplitude = cfg_getint(config, optionName[AMPLITUDE]);
+	}
+	if (!cfg_size(config, optionName[GENERATOR])) {
+		return (SUCCESS);
+	}
+	char *generator = cfg_getstr(config, optionName[GENERATOR]);
+	if (!strcmp(generator, "lal")) {
+		method->generator = LAL_GENERATOR;
+	} else if (!strcmp(generator, "chirp")) {
+		method->generator = CHIRP_GENERATOR;
+	} else {
+		fprintf(stderr, "Unknown generator \"%s\", use \"lal\" or \"chirp\".\n", generator);
+		return (FAILURE);
+	}
+	return (SUCCESS);
 }
 
-static void destroyWavePair(WavePair **pair) {
-	if (*pair) {
-		if ((*pair)->wave) {
-			free((*pair)->wave);
-		}
-		if ((*pair)->name) {
-			free((*pair)->name);
-		}
-		free(*pair);
+static void parseBinary(cfg_t *config, Binary *binary) {
+	for (int blackhole = FIRST; blackhole < BH; blackhole++) {
+		resolveFloat(config, MASS, blackhole, &binary->mass[blackhole]);
 	}
+	resolveAngle(config, INCLINATION, 0, &binary->inclination);
+	resolveFloat(config, DISTANCE, 0, &binary->distance);
+	parseSpin(config ? cfg_getsec(config, optionName[SPIN]) : NULL, &binary->spin);
 }
 
-static int createList(double first, double second, char *text) {
-	sprintf(text, "{%g, %g}", first, second);
-	return (SUCCESS);
+/**
+ * Parses the wave over the defaults.
+ * @param[in]  config   the section of the wave, NULL takes every parameter from the defaults.
+ * @param[in]  defaults the omitted parameters.
+ * @param[out] wave     the parameters of the wave.
+ * @return failure code
+ */
+static int parseWave(cfg_t *config, const Wave *defaults, Wave *wave) {
+	*wave = *defaults;
+	if (!config) {
+		return (SUCCESS);
+	}
+	parseBinary(cfg_getsec(config, optionName[BINARY]), &wave->binary);
+	return (parseGeneration(cfg_getsec(config, optionName[METHOD]), &wave->method));
 }
 
-static int parsePair(cfg_t *config, Wave wave[]) {
+static int parsePair(cfg_t *config, const Wave *defaults, Wave wave[]) {
 	int failure = SUCCESS;
-	for (size_t current = FIRST; current < cfg_size(config, optionName[WAVEX]); current++) {
-		cfg_t *waveConfig = cfg_getnsec(config, optionName[WAVEX], current);
-		failure &= parseWave(waveConfig, &wave[current]);
+	for (unsigned current = FIRST; current < BH; current++) {
+		cfg_t *waveConfig = current < cfg_size(config, optionName[WAVEX]) ?
+		        cfg_getnsec(config, optionName[WAVEX], current) : NULL;
+		failure |= parseWave(waveConfig, defaults, &wave[current]);
 	}
 	return (failure);
 }
@@ -177,6 +223,9 @@ static int parsePair(cfg_t *config, Wave wave[]) {
 #define numberConstant 1
 #define differenceConstant "{2, 2}"
 #define genConstant "{true, true, true, true}"
+#define formatConstant "text"
+#define windowConstant "{0.0, 0.0}"
+#define sinkConstant "full"
 
 Option option = {	//
         { CFG_STR(optionName[ANGLE], "deg", CFGF_NONE),
@@ -184,199 +233,183 @@ Option option = {	//
         CFG_STR(optionName[DISTANCE], "Mpc", CFGF_NONE),
         CFG_END()
     }, {
-        CFG_FLOAT_LIST(optionName[MAGNITUDE], "{1.0, 1.0}", CFGF_NONE),
-        CFG_FLOAT_LIST(optionName[INCLINATION], "{0.0, 0.0}", CFGF_NONE),
-        CFG_FLOAT_LIST(optionName[AZIMUTH], "{0.0, 0.0}", CFGF_NONE),
+        CFG_FLOAT_LIST(optionName[MAGNITUDE], 0, CFGF_NODEFAULT),
+        CFG_FLOAT_LIST(optionName[INCLINATION], 0, CFGF_NODEFAULT),
+        CFG_FLOAT_LIST(optionName[AZIMUTH], 0, CFGF_NODEFAULT),
         CFG_STR(optionName[COORDINATE_SYSTEM], coordinateSystemConstant, CFGF_NONE),
         CFG_END()
     }, {
-        CFG_FLOAT_LIST(optionName[MASS], "{3.0, 3.0}", CFGF_NONE),
+        CFG_FLOAT_LIST(optionName[MASS], 0, CFGF_NODEFAULT),
         CFG_SEC(optionName[SPIN], option.spin, CFGF_NONE),
-        CFG_FLOAT(optionName[INCLINATION], 10.0, CFGF_NONE),
-        CFG_FLOAT(optionName[DISTANCE], 1.0, CFGF_NONE),
+        CFG_FLOAT(optionName[INCLINATION], 0.0, CFGF_NODEFAULT),
+        CFG_FLOAT(optionName[DISTANCE], 0.0, CFGF_NODEFAULT),
         CFG_END()
     }, {
-        CFG_STR_LIST(optionName[SPIN], "{ALL, ALL}", CFGF_NONE),
-        CFG_INT_LIST(optionName[PHASE], "{4, 4}", CFGF_NONE),
-        CFG_INT_LIST(optionName[AMPLITUDE], "{0, 0}", CFGF_NONE),
+        CFG_STR(optionName[SPIN], 0, CFGF_NODEFAULT),
+        CFG_INT(optionName[PHASE], 0, CFGF_NODEFAULT),
+        CFG_INT(optionName[AMPLITUDE], 0, CFGF_NODEFAULT),
+        CFG_STR(optionName[GENERATOR], 0, CFGF_NODEFAULT),
         CFG_END()
     }, {
         CFG_SEC(optionName[BINARY], option.binary, CFGF_NONE),
         CFG_SEC(optionName[METHOD], option.method, CFGF_NONE),
         CFG_END()
     }, {
-        CFG_SEC(optionName[WAVEX], option.defaultWave, CFGF_MULTI),
+        CFG_SEC(optionName[WAVEX], option.wave, CFGF_MULTI),
         CFG_END()
     }, {
-        CFG_SEC(optionName[WAVEX], option.defaultWave, CFGF_MULTI),
+        CFG_SEC(optionName[WAVEX], option.wave, CFGF_MULTI),
         CFG_INT_LIST(optionName[DIFF], differenceConstant, CFGF_NONE),
         CFG_BOOL_LIST(optionName[GENERATE], genConstant, CFGF_NONE),
         CFG_END()
+    }, {
+        CFG_INT(optionName[STRIDE], 1, CFGF_NONE),
+        CFG_BOOL(optionName[ANTI_ALIAS], cfg_true, CFGF_NONE),
+        CFG_FLOAT_LIST(optionName[WINDOW], windowConstant, CFGF_NONE),
+        CFG_FLOAT(optionName[LAST], 0.0, CFGF_NONE),
+        CFG_END()
     }, {
         CFG_STR(optionName[OUTPUT], outputConstant, CFGF_NONE),
         CFG_SEC(optionName[UNIT], option.units, CFGF_NONE),
         CFG_FLOAT_LIST(optionName[BOUNDARY_FREQUENCY], boundaryFrequencyConstant, CFGF_NONE),
         CFG_FLOAT(optionName[SAMPLING_FREQUENCY], samplingFrequencyConstant, CFGF_NONE),
-        CFG_SEC(optionName[WAVEX], option.defaultWave, CFGF_TITLE | CFGF_MULTI),
+        CFG_SEC(optionName[WAVEX], option.wave, CFGF_TITLE | CFGF_MULTI),
         CFG_SEC(optionName[PAIR], option.pair, CFGF_TITLE | CFGF_MULTI),
         CFG_SEC(optionName[STEP], option.step, CFGF_TITLE | CFGF_MULTI),
+        CFG_STR(optionName[FORMAT], formatConstant, CFGF_NONE),
+        CFG_SEC(optionName[DUMP], option.dump, CFGF_TITLE | CFGF_MULTI),
+        CFG_STR(optionName[SINK], sinkConstant, CFGF_NONE),
         CFG_END()
     }
 };
 
-static int parse(char *file, Parameter *parameters) {
-	parameters->exactTrue = parameters->stepTrue = false;
-	int failure = SUCCESS;
-	cfg_t *config = cfg_init(option.option, CFGF_NONE);
-	failure = cfg_parse(config, file) == CFG_PARSE_ERROR;
-	if (!failure) {
-		failure = parseFrequency(config, parameters);
-		for (size_t current = FIRST; current < cfg_size(config, optionName[WAVEX]); current++) {
-			cfg_t *wave = cfg_getsec(config, optionName[WAVEX]);
-			if (strstr("default", cfg_title(wave))) {
-				parameters->exactTrue = true;
-				failure &= parseWave(wave, &defaultWave);
-				break;
-			}
-		}
-		for (size_t current = FIRST; current < cfg_size(config, optionName[STEP]); current++) {
-			cfg_t *step = cfg_getsec(config, optionName[STEP]);
-			if (strstr("default", cfg_title(step))) {
-				parameters->stepTrue = true;
-				failure &= parsePair(step, parameters->boundary);
-				for (int current = FIRST; current < BH; current++) {
-					parameters->numberOfStep[current] = cfg_getnint(step, optionName[DIFF], current);
-					if (parameters->numberOfStep[current] < 2) {
-						parameters->numberOfStep[current] = 2;
-					}
-				}
-				for (size_t current = FIRST; current < cfg_size(step, optionName[GENERATE]); current++) {
-					parameters->gen[current] = cfg_getnbool(step, optionName[GENERATE], current);
-				}
-				break;
-			}
-		}
+static int parseFormat(const char *name, DumpFormat *format) {
+	if (!strcmp(name, "text")) {
+		*format = TEXT_FORMAT;
+	} else if (!strcmp(name, "binary")) {
+		*format = BINARY_FORMAT;
+	} else {
+		fprintf(stderr, "Unknown dump format \"%s\", use \"text\" or \"binary\".\n", name);
+		return (FAILURE);
 	}
-	cfg_free(config);
-	return (failure);
+	return (SUCCESS);
 }
 
-static int initOptions(char *file, Parameter *parameter, cfg_t **config) {
-	int failure = parse(file, parameter);
-	string magnitude, inclination, azimuth;
-	createList(defaultWave.binary.spin.magnitude[FIRST], defaultWave.binary.spin.magnitude[SECOND], magnitude);
-	createList(degreeFromRadian(defaultWave.binary.spin.inclination[FIRST]),
-	        degreeFromRadian(defaultWave.binary.spin.inclination[SECOND]), inclination);
-	createList(degreeFromRadian(defaultWave.binary.spin.azimuth[FIRST]),
-	        degreeFromRadian(defaultWave.binary.spin.azimuth[SECOND]), azimuth);
-	cfg_opt_t spin[SPIN_SIZE] = { //
-	        CFG_FLOAT_LIST(optionName[MAGNITUDE], magnitude, CFGF_NONE),
-	        CFG_FLOAT_LIST(optionName[INCLINATION], inclination, CFGF_NONE),
-	        CFG_FLOAT_LIST(optionName[AZIMUTH], azimuth, CFGF_NONE),
-	        CFG_STR(optionName[COORDINATE_SYSTEM], coordinateSystemConstant, CFGF_NONE),
-	        CFG_END()
-        };
-	string mass;
-	createList(defaultWave.binary.mass[FIRST], defaultWave.binary.mass[SECOND], mass);
-	cfg_opt_t binary[BINARY_SIZE] = { //
-	        CFG_FLOAT_LIST(optionName[MASS], mass, CFGF_NONE),
-	        CFG_SEC(optionName[SPIN], spin, CFGF_NONE),
-	        CFG_FLOAT(optionName[INCLINATION], defaultWave.binary.inclination, CFGF_NONE),
-	        CFG_FLOAT(optionName[DISTANCE], defaultWave.binary.distance, CFGF_NONE),
-	        CFG_END()
-        };
-	cfg_opt_t method[METHOD_SIZE] = { //
-	        CFG_STR(optionName[SPIN], defaultWave.method.spin, CFGF_NONE),
-	        CFG_INT(optionName[PHASE], defaultWave.method.phase, CFGF_NONE),
-	        CFG_INT(optionName[AMPLITUDE], defaultWave.method.amplitude, CFGF_NONE),
-	        CFG_END()
-        };
-	cfg_opt_t wave[WAVE_SIZE] = { //
-	        CFG_SEC(optionName[BINARY], binary, CFGF_NONE),
-	        CFG_SEC(optionName[METHOD], method, CFGF_NONE),
-	        CFG_END()
-        };
-	cfg_opt_t pair[PAIR_SIZE] = {	//
-	        CFG_SEC(optionName[WAVEX], wave, CFGF_MULTI),
-	        CFG_END()
-        };
-	cfg_opt_t step[STEP_SIZE] = {	//
-	        CFG_SEC(optionName[WAVEX], wave, CFGF_MULTI),
-	        CFG_INT_LIST(optionName[DIFF], differenceConstant, CFGF_NONE),
-	        CFG_BOOL_LIST(optionName[GENERATE], genConstant, CFGF_NONE),
-	        CFG_END()
-        };
-	cfg_opt_t options[OPTION_SIZE] = {	//
-	        CFG_STR(optionName[OUTPUT], outputConstant, CFGF_NONE),
-	        CFG_SEC(optionName[UNIT], option.units, CFGF_NONE),
-	        CFG_FLOAT_LIST(optionName[BOUNDARY_FREQUENCY], boundaryFrequencyConstant, CFGF_NONE),
-	        CFG_FLOAT(optionName[SAMPLING_FREQUENCY], samplingFrequencyConstant, CFGF_NONE),
-	        CFG_SEC(optionName[WAVEX], option.defaultWave, CFGF_TITLE | CFGF_MULTI),
-	        CFG_SEC(optionName[PAIR], pair, CFGF_TITLE | CFGF_MULTI),
-	        CFG_SEC(optionName[STEP], step, CFGF_TITLE | CFGF_MULTI),
-	        CFG_END()
-        };
-	*config = cfg_init(options, CFGF_NONE);
-	return (failure);
+static int parseSink(const char *name, OutputSink *sink) {
+	if (!strcmp(name, "full")) {
+		*sink = FULL_SINK;
+	} else if (!strcmp(name, "summary")) {
+		*sink = SUMMARY_SINK;
+	} else if (!strcmp(name, "null")) {
+		*sink = NULL_SINK;
+	} else {
+		fprintf(stderr, "Unknown sink \"%s\", use \"full\", \"summary\" or \"null\".\n", name);
+		return (FAILURE);
+	}
+	return (SUCCESS);
 }
 
-cfg_t *config;
-
-int initParser(char *file, Parameter *parameter, string outputDir) {
-	memset(&defaultWave, 0, sizeof(Wave));
-	strcpy(outputDir, outputConstant);
-	strcpy(defaultWave.name, "wave");
-	strcpy(defaultWave.method.spin, "ALL");
-	defaultWave.method.phase = 4;
-	defaultWave.method.amplitude = 2;
-	defaultWave.binary.distance = 1.0;
-	defaultWave.binary.mass[FIRST] = 3.0;
-	defaultWave.binary.mass[SECOND] = 3.0;
-	int failure = initOptions(file, parameter, &config);
-	failure &= cfg_parse(config, file) == CFG_PARSE_ERROR;
-	char *output = cfg_getstr(config, optionName[OUTPUT]);
-	strcpy(outputDir, output);
-	return (failure);
+/**
+ * Parses the sample selections of the dumps, the sections are titled by the names of the dumps.
+ * @param[in]  config the configuration.
+ * @param[out] dump   the sample selections.
+ * @return failure code
+ */
+static int parseDumps(cfg_t *config, DumpOption dump[]) {
+	for (int kind = SPIN_DUMP; kind < NUMBER_OF_DUMP; kind++) {
+		dump[kind] = (DumpOption ) { 1, true, { 0.0, 0.0 }, 0.0 };
+	}
+	for (size_t current = FIRST; current < cfg_size(config, optionName[DUMP]); current++) {
+		cfg_t *section = cfg_getnsec(config, optionName[DUMP], current);
+		int kind;
+		for (kind = SPIN_DUMP; kind < NUMBER_OF_DUMP && strcmp(cfg_title(section), getDumpName(kind)); kind++) {
+		}
+		if (kind == NUMBER_OF_DUMP) {
+			fprintf(stderr, "Unknown dump \"%s\", use \"spin\", \"system\" or \"wave\".\n", cfg_title(section));
+			return (FAILURE);
+		}
+		long stride = cfg_getint(section, optionName[STRIDE]);
+		dump[kind].stride = stride > 1 ? (size_t) stride : 1;
+		dump[kind].antiAlias = cfg_getbool(section, optionName[ANTI_ALIAS]);
+		dump[kind].window[MIN] = cfg_getnfloat(section, optionName[WINDOW], MIN);
+		dump[kind].window[MAX] = cfg_getnfloat(section, optionName[WINDOW], MAX);
+		dump[kind].last = cfg_getfloat(section, optionName[LAST]);
+	}
+	return (SUCCESS);
 }
 
-int parseWaves(char *file, Parameter *parameter) {
-	int failure = SUCCESS;
-	failure &= cfg_parse(config, file) == CFG_PARSE_ERROR;
-	if (!failure) {
-		parameter->exact = createWavePair(cfg_size(config, optionName[PAIR]));
-		for (size_t current = FIRST; current < parameter->exact->length; current++) {
-			cfg_t *pair = cfg_getnsec(config, optionName[PAIR], current);
-			sprintf(parameter->exact->name[current], "%s", cfg_title(pair));
-			failure |= parsePair(pair, &parameter->exact->wave[2 * current]);
+/**
+ * Parses the statistic: the bounds from the step titled "default", the stepped pairs from the others.
+ * @param[in]     config      the configuration.
+ * @param[in]     defaultWave defaults of the stepped pairs.
+ * @param[in,out] plan        the plan.
+ * @return failure code
+ */
+static int parseSteps(cfg_t *config, const Wave *defaultWave, JobPlan *plan) {
+	cfg_t *bounds = cfg_gettsec(config, optionName[STEP], "default");
+	plan->stepTrue = bounds != NULL;
+	if (!bounds) {
+		return (SUCCESS);
+	}
+	int failure = parsePair(bounds, &sectionDefaults, plan->boundary);
+	for (int current = FIRST; current < BH; current++) {
+		long number = cfg_getnint(bounds, optionName[DIFF], current);
+		plan->numberOfStep[current] = number < 2 ? 2 : (size_t) number;
+	}
+	for (unsigned current = FIRST; current < cfg_size(bounds, optionName[GENERATE]) && current < GEN; current++) {
+		plan->gen[current] = cfg_getnbool(bounds, optionName[GENERATE], current);
+	}
+	plan->step = calloc(cfg_size(config, optionName[STEP]), sizeof(PairJob));
+	for (unsigned current = FIRST; current < cfg_size(config, optionName[STEP]); current++) {
+		cfg_t *step = cfg_getnsec(config, optionName[STEP], current);
+		if (strcmp(cfg_title(step), "default")) {
+			PairJob *job = &plan->step[plan->stepLength++];
+			strncpy(job->name, cfg_title(step), STRING_LENGTH - 1);
+			failure |= parsePair(step, defaultWave, job->pair);
 		}
 	}
 	return (failure);
 }
 
-int parseStep(char *file, Parameter *parameter) {
-	int failure = SUCCESS;
-	failure &= cfg_parse(config, file) == CFG_PARSE_ERROR;
-	if (!failure) {
-		parameter->step = createWavePair(cfg_size(config, optionName[STEP]) - 1);
-		for (size_t current = FIRST, index = FIRST; current < parameter->step->length + 1; current++) {
-			cfg_t *step = cfg_getnsec(config, optionName[STEP], current);
-			if (!strstr("default", cfg_title(step))) {
-				sprintf(parameter->step->name[index], "%s", cfg_title(step));
-				failure |= parsePair(step, &parameter->step->wave[2 * index]);
-				index++;
-			}
-		}
+int parsePlan(const char *file, JobPlan *plan) {
+	memset(plan, 0, sizeof(JobPlan));
+	cfg_t *config = cfg_init(option.option, CFGF_NONE);
+	if (cfg_parse(config, file) != CFG_SUCCESS) {
+		fprintf(stderr, "Couldn't parse the configuration file %s.\n", file);
+		cfg_free(config);
+		return (FAILURE);
 	}
+	Parameter *parameter = &plan->parameter;
+	int failure = parseFrequency(config, parameter);
+	strncpy(plan->outputDir, cfg_getstr(config, optionName[OUTPUT]), STRING_LENGTH - 1);
+	failure |= parseFormat(cfg_getstr(config, optionName[FORMAT]), &parameter->format);
+	failure |= parseDumps(config, parameter->dump);
+	failure |= parseSink(cfg_getstr(config, optionName[SINK]), &parameter->sink);
+	Wave defaultWave;
+	cfg_t *defaultConfig = cfg_gettsec(config, optionName[WAVEX], "default");
+	plan->exactTrue = defaultConfig != NULL;
+	failure |= parseWave(defaultConfig, defaultConfig ? &sectionDefaults : &missingDefaults, &defaultWave);
+	plan->defaultWave = defaultWave;
+	plan->exactLength = cfg_size(config, optionName[PAIR]);
+	plan->exact = calloc(plan->exactLength + 1, sizeof(PairJob));
+	for (unsigned current = FIRST; current < plan->exactLength; current++) {
+		cfg_t *pair = cfg_getnsec(config, optionName[PAIR], current);
+		strncpy(plan->exact[current].name, cfg_title(pair), STRING_LENGTH - 1);
+		failure |= parsePair(pair, &defaultWave, plan->exact[current].pair);
+	}
+	failure |= parseSteps(config, &defaultWave, plan);
+	cfg_free(config);
 	return (failure);
 }
 
-void cleanParameter(Parameter *parameter) {
-	destroyWavePair(&parameter->exact);
-	destroyWavePair(&parameter->step);
-	cfg_free(config);
+void cleanPlan(JobPlan *plan) {
+	free(plan->exact);
+	free(plan->step);
+	plan->exact = plan->step = NULL;
+	plan->exactLength = plan->stepLength = 0;
 }
 
-static int printWaveParameter(FILE *file, Wave *wave) {
+static int printWaveParameter(FILE *file, const Wave *wave) {
 	fprintf(file, "%11.5s\n", wave->name);
 	fprintf(file, "%11s % 11.0d % 11.0d\n", wave->method.spin, wave->method.phase, wave->method.amplitude);
 	fprintf(file, "% 11.5g % 11.5g % 11.5g % 11.5g\n", wave->binary.mass[0], wave->binary.mass[1],
@@ -391,19 +424,81 @@ static int printWaveParameter(FILE *file, Wave *wave) {
 	return (SUCCESS);
 }
 
-int printParameter(FILE *file, Parameter *parameter, int from, int to) {
+int printPlan(FILE *file, const JobPlan *plan) {
 	int failure = SUCCESS;
-	fprintf(file, "% 11.5g % 11.5g % 11.5g\n", parameter->initialFrequency, parameter->endingFrequency,
-	        parameter->samplingFrequency);
-	for (int current = from; current < to; current++) {
-		failure |= printWaveParameter(file, &parameter->exact->wave[current]);
+	fprintf(file, "% 11.5g % 11.5g % 11.5g\n", plan->parameter.initialFrequency, plan->parameter.endingFrequency,
+	        plan->parameter.samplingFrequency);
+	for (size_t current = 0; current < plan->exactLength; current++) {
+		for (int wave = FIRST; wave < BH; wave++) {
+			failure |= printWaveParameter(file, &plan->exact[current].pair[wave]);
+		}
 	}
-	puts("Step:");
+	fputs("Step:\n", file);
 	for (int boundary = MIN; boundary < MINMAX; boundary++) {
-		failure |= printWaveParameter(file, &parameter->boundary[boundary]);
+		failure |= printWaveParameter(file, &plan->boundary[boundary]);
 	}
-	for (int current = from; current < to; current++) {
-		failure |= printWaveParameter(file, &parameter->step->wave[current]);
+	for (size_t current = 0; current < plan->stepLength; current++) {
+		for (int wave = FIRST; wave < BH; wave++) {
+			failure |= printWaveParameter(file, &plan->step[current].pair[wave]);
+		}
 	}
 	return (failure);
 }
+
+#ifdef TEST
+
+static bool hasSectionDefaults(const Wave *wave) {
+	return (wave->binary.spin.magnitude[FIRST] == 1.0 && wave->binary.spin.magnitude[SECOND] == 1.0
+	        && isNear(wave->binary.inclination, M_PI / 18.0, 1e-12) && wave->method.amplitude == 0);
+}
+
+static bool hasMissingDefaults(const Wave *wave) {
+	return (wave->binary.spin.magnitude[FIRST] == 0.0 && wave->binary.spin.magnitude[SECOND] == 0.0
+	        && wave->binary.inclination == 0.0 && wave->method.amplitude == 2);
+}
+
+/**
+ * Parses a configuration into the plan.
+ * @param[in]  text the configuration.
+ * @param[out] plan the plan.
+ * @return failure code
+ */
+static int parseText(const char *text, JobPlan *plan) {
+	char path[] = "/tmp/parser_confuseXXXXXX";
+	int descriptor = mkstemp(path);
+	if (descriptor < 0) {
+		return (FAILURE);
+	}
+	FILE *file = fdopen(descriptor, "w");
+	fputs(text, file);
+	fclose(file);
+	int failure = parsePlan(path, plan);
+	remove(path);
+	return (failure);
+}
+
+bool isOK_parsePlan(void) {
+	static const char partial[] = "wave default { binary { mass = {5.0, 5.0} } }\n"
+	        "pair omitted { wave {} wave {} }\n"
+	        "step default { wave { binary { mass = {3.0, 3.0} } } wave { binary { mass = {30.0, 30.0} } } }\n"
+	        "step stepped { wave {} wave {} }\n";
+	static const char missing[] = "step default { wave {} wave {} }\nstep stepped { wave {} wave {} }\n";
+	JobPlan plan;
+	SAVE_FUNCTION_CALLER();
+	bool isOK = !parseText(partial, &plan) && plan.exactLength == 1 && plan.stepLength == 1
+	        && hasSectionDefaults(&plan.exact[0].pair[FIRST]) && hasSectionDefaults(&plan.boundary[MIN])
+	        && hasSectionDefaults(&plan.boundary[MAX]) && hasSectionDefaults(&plan.step[0].pair[SECOND])
+	        && plan.exact[0].pair[SECOND].binary.mass[FIRST] == 5.0;
+	cleanPlan(&plan);
+	isOK = isOK && !parseText(missing, &plan) && plan.stepLength == 1 && hasSectionDefaults(&plan.boundary[MIN])
+	        && hasMissingDefaults(&plan.step[0].pair[FIRST]);
+	cleanPlan(&plan);
+	if (!isOK) {
+		PRINT_ERROR();
+		return false;
+	}
+	PRINT_OK();
+	return true;
+}
+
+#endif	// TEST
@@ -0,0 +1,137 @@
+/**	@file   pipeline.c
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Overlapped generation, matching and writing of the jobs.
+ */
+
+#include <stdlib.h>
+#include "pipeline.h"
+#include "queue.h"
+#include "trace.h"
+
+enum {
+	QUEUE_PER_THREAD = 2,	///< capacity of the queues per computing thread.
+};
+
+/** Data shared by the stages. */
+typedef struct {
+	size_t length;	///< number of the jobs.
+	const Stages *stages;	///< the stages.
+	void *context;	///< passed to the stages.
+	Scheduler *scheduler;	///< hands out the jobs to the generators.
+	Queue *generated;	///< generated items waiting for the analysis.
+	Queue *analysed;	///< analysed items waiting for the writer.
+	size_t taken;	///< number of the items taken by the analysers.
+} Pipeline;
+
+/** Data of one thread of a pool. */
+typedef struct {
+	Pipeline *pipeline;	///< the shared data.
+	size_t self;	///< index of the thread in its pool.
+} Stage;
+
+static void *generate(void *argument) {
+	Stage *stage = argument;
+	Pipeline *pipeline = stage->pipeline;
+	nameTraceThread("generator", stage->self);
+	size_t job;
+	while (nextJob(pipeline->scheduler, stage->self, &job)) {
+		void *item = pipeline->stages->generate(job, pipeline->context);
+		enqueue(pipeline->generated, job, item);
+	}
+	return (NULL);
+}
+
+static void *analyse(void *argument) {
+	Pipeline *pipeline = ((Stage *) argument)->pipeline;
+	nameTraceThread("analyser", ((Stage *) argument)->self);
+	size_t job;
+	void *item;
+	while (__atomic_fetch_add(&pipeline->taken, 1, __ATOMIC_RELAXED) < pipeline->length) {
+		dequeue(pipeline->generated, &job, &item);
+		if (job == pipeline->length) {
+			break;
+		}
+		pipeline->stages->analyse(job, item, pipeline->context);
+		enqueue(pipeline->analysed, job, item);
+	}
+	return (NULL);
+}
+
+/**
+ * Writes the items as they arrive and emits the ordered outputs once all of the preceding jobs are
+ * written.
+ * @param[in] pipeline the shared data.
+ */
+static void writeItems(Pipeline *pipeline) {
+	bool *written = calloc(pipeline->length, sizeof(bool));
+	size_t next = 0, job;
+	void *item;
+	for (size_t current = 0; current < pipeline->length; current++) {
+		dequeue(pipeline->analysed, &job, &item);
+		pipeline->stages->write(job, item, pipeline->context);
+		finishJob(pipeline->scheduler, job);
+		written[job] = true;
+		while (next < pipeline->length && written[next]) {
+			if (pipeline->stages->emit) {
+				pipeline->stages->emit(next, pipeline->context);
+			}
+			next++;
+		}
+	}
+	free(written);
+}
+
+static void runSerially(size_t length, const Stages *stages, void *context) {
+	for (size_t job = 0; job < length; job++) {
+		void *item = stages->generate(job, context);
+		stages->analyse(job, item, context);
+		stages->write(job, item, context);
+		if (stages->emit) {
+			stages->emit(job, context);
+		}
+	}
+}
+
+int runPipeline(size_t length, const JobEstimate *estimate, size_t threads, const Stages *stages, void *context) {
+	nameTraceThread("writer", 0);
+	if (threads < 2 || length < 2) {
+		runSerially(length, stages, context);
+		return (SUCCESS);
+	}
+	size_t generators = (threads + 1) / 2;
+	size_t analysers = threads - generators;
+	Pipeline pipeline = { length, stages, context, createScheduler(length, estimate, generators),
+	        createQueue(QUEUE_PER_THREAD * threads), createQueue(QUEUE_PER_THREAD * threads), 0 };
+	pthread_t generator[generators], analyser[analysers];
+	Stage generatorStage[generators], analyserStage[analysers];
+	for (size_t current = 0; current < generators; current++) {
+		generatorStage[current] = (Stage ) { &pipeline, current };
+	}
+	for (size_t current = 0; current < analysers; current++) {
+		analyserStage[current] = (Stage ) { &pipeline, current };
+	}
+	size_t startedAnalysers = startThreads(analysers, analyse, analyserStage, sizeof(Stage), analyser);
+	size_t startedGenerators = 0;
+	if (startedAnalysers) {
+		startedGenerators = startThreads(generators, generate, generatorStage, sizeof(Stage), generator);
+	}
+	if (startedGenerators) {
+		writeItems(&pipeline);
+	} else {
+		for (size_t current = 0; current < startedAnalysers; current++) {
+			enqueue(pipeline.generated, length, NULL);
+		}
+		runSerially(length, stages, context);
+	}
+	for (size_t current = 0; current < startedGenerators; current++) {
+		pthread_join(generator[current], NULL);
+	}
+	for (size_t current = 0; current < startedAnalysers; current++) {
+		pthread_join(analyser[current], NULL);
+	}
+	destroyQueue(&pipeline.generated);
+	destroyQueue(&pipeline.analysed);
+	destroyScheduler(&pipeline.scheduler);
+	return (SUCCESS);
+}
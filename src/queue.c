@@ -0,0 +1,103 @@
+/**	@file   queue.c
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Bounded lock-free multi-producer multi-consumer queue.
+ */
+
+#include <sched.h>
+#include <stdlib.h>
+#include <time.h>
+#include "queue.h"
+
+enum {
+	SPINS = 64,	///< number of the retries before yielding the processor.
+	YIELDS = 2 * SPINS,	///< number of the retries before sleeping.
+	NAP = 50000,	///< length of the sleep in nanoseconds.
+};
+
+/**
+ * Backs off after an unsuccessful try: spins first, then yields, then sleeps.
+ * @param[in] retry number of the unsuccessful tries.
+ */
+static void backOff(size_t retry) {
+	if (retry > YIELDS) {
+		struct timespec nap = { 0, NAP };
+		nanosleep(&nap, NULL);
+	} else if (retry > SPINS) {
+		sched_yield();
+	}
+}
+
+Queue *createQueue(size_t capacity) {
+	size_t size = 2;
+	while (size < capacity) {
+		size *= 2;
+	}
+	Queue *queue = calloc(1, sizeof(Queue));
+	queue->cell = calloc(size, sizeof(QueueCell));
+	queue->mask = size - 1;
+	for (size_t position = 0; position < size; position++) {
+		queue->cell[position].sequence = position;
+	}
+	return (queue);
+}
+
+void destroyQueue(Queue **queue) {
+	free((*queue)->cell);
+	free(*queue);
+	*queue = NULL;
+}
+
+bool tryEnqueue(Queue *queue, size_t job, void *item) {
+	size_t position = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+	for (;;) {
+		QueueCell *cell = &queue->cell[position & queue->mask];
+		size_t sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+		if (sequence == position) {
+			if (__atomic_compare_exchange_n(&queue->head, &position, position + 1, true, __ATOMIC_RELAXED,
+			        __ATOMIC_RELAXED)) {
+				cell->job = job;
+				cell->item = item;
+				__atomic_store_n(&cell->sequence, position + 1, __ATOMIC_RELEASE);
+				return (true);
+			}
+		} else if (sequence < position) {
+			return (false);
+		} else {
+			position = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+		}
+	}
+}
+
+bool tryDequeue(Queue *queue, size_t *job, void **item) {
+	size_t position = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+	for (;;) {
+		QueueCell *cell = &queue->cell[position & queue->mask];
+		size_t sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+		if (sequence == position + 1) {
+			if (__atomic_compare_exchange_n(&queue->tail, &position, position + 1, true, __ATOMIC_RELAXED,
+			        __ATOMIC_RELAXED)) {
+				*job = cell->job;
+				*item = cell->item;
+				__atomic_store_n(&cell->sequence, position + queue->mask + 1, __ATOMIC_RELEASE);
+				return (true);
+			}
+		} else if (sequence < position + 1) {
+			return (false);
+		} else {
+			position = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+		}
+	}
+}
+
+void enqueue(Queue *queue, size_t job, void *item) {
+	for (size_t retry = 0; !tryEnqueue(queue, job, item); retry++) {
+		backOff(retry);
+	}
+}
+
+void dequeue(Queue *queue, size_t *job, void **item) {
+	for (size_t retry = 0; !tryDequeue(queue, job, item); retry++) {
+		backOff(retry);
+	}
+}
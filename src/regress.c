@@ -0,0 +1,491 @@
+/**	@file   regress.c
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Regression check of the match results and the runtime.
+ *
+ *	A fixed set of pairs is generated and analysed like the exact pairs of the main program. With
+ *	--check the results are compared with the golden values, regression.golden in the repository, and
+ *	the program fails if any match, period or length drifts beyond the tolerances; the cases missing
+ *	from the golden values are skipped. The golden values cover the chirp backend, whose results do not
+ *	depend on the LAL version, make check runs only its cases; --record writes them, it is run by hand
+ *	when a change is intended. The two waves of a case differ, so the matches cover the
+ *	orthonormalisation, the correlation and the search of the peak; the noise curve is an analytic fit,
+ *	so they don't depend on the noise tables of LALSimulation either.
+ *	The runtimes are not portable, --record-timing writes the median runtime of every case into a
+ *	baseline of the machine and --check-timing fails if any case got slower than the allowed ratio.
+ */
+
+#include <getopt.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dump.h"
+#include "generator_lal.h"
+#include "timing.h"
+
+/** Settings of the regression check. */
+typedef struct {
+	const char *record;	///< the results are written here if not NULL.
+	const char *check;	///< the golden results are read from here if not NULL.
+	const char *recordTiming;	///< the runtimes are written here if not NULL.
+	const char *checkTiming;	///< the baseline runtimes are read from here if not NULL.
+	size_t repetitions;	///< number of the measured repetitions of a case.
+	double matchTolerance;	///< allowed absolute difference of the matches.
+	double lengthTolerance;	///< allowed relative difference of the lengths and the relative values.
+	size_t periodTolerance;	///< allowed difference of the number of the periods.
+	double slowdown;	///< allowed relative increase of the runtime.
+	double minimalTime;	///< runtimes below this are not compared, in seconds.
+	double initialFrequency;	///< initial frequency of the generated waves.
+	double samplingFrequency;	///< sampling frequency of the generated waves.
+	GeneratorKind generator;	///< backend of the cases, NUMBER_OF_GENERATOR runs every backend.
+} Regress;
+
+/** Result of a case. */
+typedef struct {
+	string name;	///< name of the case, without whitespace.
+	Analysed analysed;	///< results of the analysis.
+	double time;	///< median runtime of the generation and the analysis in seconds.
+} RegressResult;
+
+enum {
+	CASES = 32,	///< maximal number of the cases in the baseline.
+};
+
+/** A case of the check, the two waves differ in the fields the backends respect. */
+typedef struct {
+	const char *name;	///< what the case covers.
+	double mass[NUMBER_OF_WAVE][BH];	///< masses of the blackholes of the waves.
+	int phase[NUMBER_OF_WAVE];	///< double of the PN orders in phase of the waves.
+	const char *spin[NUMBER_OF_WAVE];	///< spin contributions of the waves, "NO" stops the precession.
+	double magnitude;	///< magnitude of the spins.
+	double tilt;	///< inclination of the spins from the orbital angular momentum.
+} RegressCase;
+
+/**
+ * The cases: different phase orders at equal and unequal masses, nearby masses with different lengths,
+ * and a precessing wave against the same binary without precession, so none of the matches is 1.
+ */
+static const RegressCase regressCase[] = { //
+        { "order", { { 10.0, 10.0 }, { 10.0, 10.0 } }, { 4, 3 }, { "ALL", "ALL" }, 0.0, 0.0 }, //
+        { "order-short", { { 30.0, 30.0 }, { 30.0, 30.0 } }, { 4, 0 }, { "ALL", "ALL" }, 0.0, 0.0 }, //
+        { "order-ratio", { { 3.0, 30.0 }, { 3.0, 30.0 } }, { 4, 2 }, { "ALL", "ALL" }, 0.0, 0.0 }, //
+        { "mass", { { 10.0, 10.0 }, { 10.3, 9.8 } }, { 4, 4 }, { "ALL", "ALL" }, 0.0, 0.0 }, //
+        { "precession", { { 5.0, 15.0 }, { 5.0, 15.0 } }, { 4, 4 }, { "NO", "ALL" }, 0.7, M_PI / 3.0 }, //
+        };
+
+/**
+ * Sets the waves of the case.
+ * @param[out] pair      the pair.
+ * @param[in]  generator backend generating the waves.
+ * @param[in]  current   the case.
+ */
+static void setPair(Wave pair[NUMBER_OF_WAVE], GeneratorKind generator, const RegressCase *current) {
+	memset(pair, 0, NUMBER_OF_WAVE * sizeof(Wave));
+	for (int wave = FIRST_WAVE; wave < NUMBER_OF_WAVE; wave++) {
+		for (int blackhole = FIRST; blackhole < BH; blackhole++) {
+			pair[wave].binary.mass[blackhole] = current->mass[wave][blackhole];
+			pair[wave].binary.spin.magnitude[blackhole] = current->magnitude;
+			pair[wave].binary.spin.inclination[blackhole] = current->tilt;
+			pair[wave].binary.spin.azimuth[blackhole] = M_PI / 2.0 * blackhole;
+		}
+		pair[wave].binary.spin.system = PRECESSING;
+		pair[wave].binary.inclination = M_PI / 6.0;
+		pair[wave].binary.distance = 1.0;
+		strcpy(pair[wave].method.spin, current->spin[wave]);
+		pair[wave].method.phase = current->phase[wave];
+		pair[wave].method.amplitude = 0;
+		pair[wave].method.generator = generator;
+	}
+}
+
+/**
+ * Analytic fit of the aLIGO zero-detuned high power noise curve, Ajith, Phys. Rev. D 84, 084037.
+ * @param[in] frequency the frequency in Hz.
+ * @return the one-sided noise spectral density.
+ */
+static double getFittedNoise(double frequency) {
+	double x = frequency / 215.0, x2 = x * x;
+	return (1e-49 * (pow(x, -4.14) - 5.0 / x2 + 111.0 * (1.0 - x2 + x2 * x2 / 2.0) / (1.0 + x2 / 2.0)));
+}
+
+/**
+ * Generates and analyses the pair like the exact pairs of the main program, but with the analytic noise
+ * curve of the context.
+ * @param[in]     regress  settings of the check.
+ * @param[in,out] context  the matching context.
+ * @param[in]     pair     parameters of the waves.
+ * @param[out]    analysed results of the analysis.
+ */
+static void analysePair(const Regress *regress, MatchContext *context, const Wave pair[NUMBER_OF_WAVE],
+        Analysed *analysed) {
+	Wave wave[NUMBER_OF_WAVE];
+	memcpy(wave, pair, sizeof(wave));
+	double samplingTime = 1.0 / regress->samplingFrequency;
+	Variable *variable = generateWaveformPair(wave, regress->initialFrequency, samplingTime);
+	size_t minIndex, maxIndex;
+	prepareMatch(context, variable->wave);
+	prepareNoise(context, regress->initialFrequency, regress->samplingFrequency);
+	indexFromFrequency(regress->initialFrequency, regress->samplingFrequency / 2.0,
+	        regress->samplingFrequency / variable->size, &minIndex, &maxIndex);
+	memset(analysed, 0, sizeof(Analysed));
+	computeMatches(context, minIndex, maxIndex, analysed);
+	computePeriods(context, samplingTime, analysed);
+	finishMatch(context);
+	destroyWaveform(&variable->wave);
+	destroyOutput(&variable);
+}
+
+/**
+ * Runs the case repeatedly, keeps the results of the last run and the median runtime.
+ * @param[in]     regress settings of the check.
+ * @param[in,out] context the matching context.
+ * @param[in]     pair    parameters of the waves.
+ * @param[out]    result  result of the case.
+ */
+static void runCase(const Regress *regress, MatchContext *context, const Wave pair[NUMBER_OF_WAVE],
+        RegressResult *result) {
+	double *duration = malloc(regress->repetitions * sizeof(double));
+	for (size_t repetition = 0; repetition < regress->repetitions; repetition++) {
+		uint64_t start = readClock();
+		analysePair(regress, context, pair, &result->analysed);
+		duration[repetition] = (readClock() - start) * 1e-9;
+	}
+	result->time = getMedian(duration, regress->repetitions);
+	free(duration);
+}
+
+/**
+ * Runs every case of the fixed set.
+ * @param[in]  regress settings of the check.
+ * @param[out] result  results of the cases.
+ * @return number of the cases
+ */
+static size_t runCases(const Regress *regress, RegressResult result[CASES]) {
+	MatchContext *context = createMatchContext();
+	setNoiseCurve(context, getFittedNoise);
+	size_t count = 0;
+	for (GeneratorKind generator = LAL_GENERATOR; generator < NUMBER_OF_GENERATOR; generator++) {
+		if (regress->generator != NUMBER_OF_GENERATOR && regress->generator != generator) {
+			continue;
+		}
+		for (size_t current = 0; current < sizeof(regressCase) / sizeof(regressCase[0]); current++) {
+			Wave pair[NUMBER_OF_WAVE];
+			setPair(pair, generator, &regressCase[current]);
+			sprintf(result[count].name, "%s/%s", getGeneratorName(generator), regressCase[current].name);
+			runCase(regress, context, pair, &result[count]);
+			fprintf(stderr, "%-32s %10.6f s\n", result[count].name, result[count].time);
+			count++;
+		}
+	}
+	destroyMatchContext(&context);
+	return (count);
+}
+
+/**
+ * Opens the output file and writes the header.
+ * @param[in] path   path of the file.
+ * @param[in] header the header line.
+ * @return the file or NULL on error.
+ */
+static FILE *openOutput(const char *path, const char *header) {
+	FILE *file = fopen(path, "w");
+	if (!file) {
+		fprintf(stderr, "Couldn't open file %s for writing.\n", path);
+		return (NULL);
+	}
+	fputs(header, file);
+	return (file);
+}
+
+/**
+ * Writes the results as whitespace separated columns with a '#' header.
+ * @param[in] path   path of the golden values.
+ * @param[in] result results of the cases.
+ * @param[in] count  number of the cases.
+ * @return failure code
+ */
+static int recordResults(const char *path, const RegressResult result[], size_t count) {
+	char header[512];
+	sprintf(header, "#%-31s %23s %23s %23s %10s %10s %23s %23s %23s %23s\n", "name", "worst", "typical", "best",
+	        "period1", "period2", "relativePeriod", "length1", "length2", "relativeLength");
+	FILE *file = openOutput(path, header);
+	if (!file) {
+		return (FAILURE);
+	}
+	for (size_t current = 0; current < count; current++) {
+		const Analysed *analysed = &result[current].analysed;
+		fprintf(file, "%-32s %23.16e %23.16e %23.16e %10zu %10zu %23.16e %23.16e %23.16e %23.16e\n",
+		        result[current].name, analysed->match[WORST], analysed->match[TYPICAL], analysed->match[BEST],
+		        analysed->period[FIRST_WAVE], analysed->period[SECOND_WAVE], analysed->relativePeriod,
+		        analysed->length[FIRST_WAVE], analysed->length[SECOND_WAVE], analysed->relativeLength);
+	}
+	return (fclose(file) ? FAILURE : SUCCESS);
+}
+
+/**
+ * Writes the median runtimes of the cases.
+ * @param[in] path   path of the baseline.
+ * @param[in] result results of the cases.
+ * @param[in] count  number of the cases.
+ * @return failure code
+ */
+static int recordTimes(const char *path, const RegressResult result[], size_t count) {
+	char header[128];
+	sprintf(header, "#%-31s %12s\n", "name", "time[s]");
+	FILE *file = openOutput(path, header);
+	if (!file) {
+		return (FAILURE);
+	}
+	for (size_t current = 0; current < count; current++) {
+		fprintf(file, "%-32s %12.6f\n", result[current].name, result[current].time);
+	}
+	return (fclose(file) ? FAILURE : SUCCESS);
+}
+
+/**
+ * Reads the file written by recordResults or recordTimes.
+ * @param[in]  path     path of the file.
+ * @param[in]  timing   the file holds runtimes instead of results.
+ * @param[out] baseline the recorded values.
+ * @return number of the cases, 0 on error.
+ */
+static size_t readBaseline(const char *path, bool timing, RegressResult baseline[CASES]) {
+	FILE *file = fopen(path, "r");
+	if (!file) {
+		fprintf(stderr, "Couldn't open file %s for reading.\n", path);
+		return (0);
+	}
+	char line[1024];
+	size_t count = 0;
+	while (count < CASES && fgets(line, sizeof(line), file)) {
+		if (line[0] == '#' || line[0] == '\n') {
+			continue;
+		}
+		RegressResult *current = &baseline[count];
+		Analysed *analysed = &current->analysed;
+		char rest;
+		int expected = timing ? 2 : 10;
+		int read = timing ? sscanf(line, "%99s %lg %c", current->name, &current->time, &rest)
+		        : sscanf(line, "%99s %lg %lg %lg %zu %zu %lg %lg %lg %lg %c", current->name, &analysed->match[WORST],
+		                &analysed->match[TYPICAL], &analysed->match[BEST], &analysed->period[FIRST_WAVE],
+		                &analysed->period[SECOND_WAVE], &analysed->relativePeriod, &analysed->length[FIRST_WAVE],
+		                &analysed->length[SECOND_WAVE], &analysed->relativeLength, &rest);
+		if (read != expected) {
+			fprintf(stderr, "Corrupt line in %s: %s", path, line);
+			fclose(file);
+			return (0);
+		}
+		count++;
+	}
+	fclose(file);
+	if (!count) {
+		fprintf(stderr, "No cases in %s.\n", path);
+	}
+	return (count);
+}
+
+static bool isRelativelyClose(double value, double expected, double tolerance) {
+	return (fabs(value - expected) <= tolerance * fmax(fabs(expected), 1.0));
+}
+
+/**
+ * Compares the result with the golden values and prints the differences.
+ * @param[in] regress  settings of the check.
+ * @param[in] result   the current result.
+ * @param[in] golden   the golden result.
+ * @return failure code
+ */
+static int compareResult(const Regress *regress, const RegressResult *result, const RegressResult *golden) {
+	int failure = SUCCESS;
+	const Analysed *current = &result->analysed, *expected = &golden->analysed;
+	static const char *matchName[MATCH] = { "worst", "typical", "best" };
+	for (int match = WORST; match < MATCH; match++) {
+		if (!(fabs(current->match[match] - expected->match[match]) <= regress->matchTolerance)) {
+			printf("%s: %s match %.16g differs from %.16g\n", result->name, matchName[match],
+			        current->match[match], expected->match[match]);
+			failure = FAILURE;
+		}
+	}
+	for (int wave = FIRST_WAVE; wave < NUMBER_OF_WAVE; wave++) {
+		size_t difference = current->period[wave] > expected->period[wave] ?
+		        current->period[wave] - expected->period[wave] : expected->period[wave] - current->period[wave];
+		if (difference > regress->periodTolerance) {
+			printf("%s: period %d is %zu instead of %zu\n", result->name, wave + 1, current->period[wave],
+			        expected->period[wave]);
+			failure = FAILURE;
+		}
+		if (!isRelativelyClose(current->length[wave], expected->length[wave], regress->lengthTolerance)) {
+			printf("%s: length %d %.16g differs from %.16g\n", result->name, wave + 1, current->length[wave],
+			        expected->length[wave]);
+			failure = FAILURE;
+		}
+	}
+	if (!isRelativelyClose(current->relativePeriod, expected->relativePeriod, regress->lengthTolerance)
+	        || !isRelativelyClose(current->relativeLength, expected->relativeLength, regress->lengthTolerance)) {
+		printf("%s: relative differences %.16g %.16g differ from %.16g %.16g\n", result->name,
+		        current->relativePeriod, current->relativeLength, expected->relativePeriod,
+		        expected->relativeLength);
+		failure = FAILURE;
+	}
+	return (failure);
+}
+
+/**
+ * Compares the runtime with the baseline of the machine.
+ * @param[in] regress  settings of the check.
+ * @param[in] result   the current result.
+ * @param[in] baseline the recorded runtime.
+ * @return failure code
+ */
+static int compareTime(const Regress *regress, const RegressResult *result, const RegressResult *baseline) {
+	if (baseline->time >= regress->minimalTime && result->time > baseline->time * (1.0 + regress->slowdown)) {
+		printf("%s: runtime %.6f s regressed from %.6f s\n", result->name, result->time, baseline->time);
+		return (FAILURE);
+	}
+	return (SUCCESS);
+}
+
+/**
+ * Compares every result with the recorded one of the same name, the results missing from the file
+ * are skipped, but at least one has to be compared.
+ * @param[in] regress settings of the check.
+ * @param[in] path    the golden values or the runtime baseline.
+ * @param[in] timing  compares the runtimes instead of the results.
+ * @param[in] result  results of the cases.
+ * @param[in] count   number of the cases.
+ * @return failure code
+ */
+static int checkBaseline(const Regress *regress, const char *path, bool timing, const RegressResult result[],
+        size_t count) {
+	RegressResult *baseline = calloc(CASES, sizeof(RegressResult));
+	size_t recorded = readBaseline(path, timing, baseline);
+	int failure = recorded ? SUCCESS : FAILURE;
+	size_t compared = 0;
+	for (size_t current = 0; recorded && current < count; current++) {
+		size_t found = 0;
+		while (found < recorded && strcmp(baseline[found].name, result[current].name)) {
+			found++;
+		}
+		if (found < recorded) {
+			failure |= timing ? compareTime(regress, &result[current], &baseline[found])
+			        : compareResult(regress, &result[current], &baseline[found]);
+			compared++;
+		}
+	}
+	free(baseline);
+	printf("%s: %zu of %zu cases compared, %s\n", path, compared, count, failure || !compared ? "FAILED" : "PASSED");
+	return (failure || !compared ? FAILURE : SUCCESS);
+}
+
+static void printUsage(const char *program) {
+	printf("Usage: %s [--check FILE] [--check-timing FILE] [--record FILE] [--record-timing FILE]\n"
+	        "       [options]\n", program);
+	puts("  --check FILE          compares the results with the golden values, regression.golden.");
+	puts("  --check-timing FILE   compares the runtimes with the baseline of the machine.");
+	puts("  --record FILE         writes the results, only for an intended change of the golden values.");
+	puts("  --record-timing FILE  writes the runtimes as the baseline of the machine.");
+	puts("  --generator NAME      runs the cases of the backend, lal, chirp or all, all by default.");
+	puts("  --repetitions N       number of the measured repetitions of a case, 3 by default.");
+	puts("  --match-tolerance X   allowed absolute difference of the matches, 1e-6 by default.");
+	puts("  --length-tolerance X  allowed relative difference of the lengths, 1e-9 by default.");
+	puts("  --period-tolerance N  allowed difference of the periods, 0 by default.");
+	puts("  --slowdown X          allowed relative increase of the runtime, 0.25 by default.");
+}
+
+static int parseArguments(int argc, char *argv[], Regress *regress) {
+	static struct option options[] = { //
+	        { "record", required_argument, NULL, 'w' }, //
+	        { "check", required_argument, NULL, 'c' }, //
+	        { "record-timing", required_argument, NULL, 'W' }, //
+	        { "check-timing", required_argument, NULL, 'C' }, //
+	        { "generator", required_argument, NULL, 'g' }, //
+	        { "repetitions", required_argument, NULL, 'r' }, //
+	        { "match-tolerance", required_argument, NULL, 'm' }, //
+	        { "length-tolerance", required_argument, NULL, 'l' }, //
+	        { "period-tolerance", required_argument, NULL, 'p' }, //
+	        { "slowdown", required_argument, NULL, 's' }, //
+	        { "help", no_argument, NULL, 'h' }, //
+	        { NULL, 0, NULL, 0 } };
+	*regress = (Regress ) { NULL, NULL, NULL, NULL, 3, 1e-6, 1e-9, 0, 0.25, 1e-3, 40.0, 4096.0,
+	        NUMBER_OF_GENERATOR };
+	int option;
+	while ((option = getopt_long(argc, argv, "h", options, NULL)) != -1) {
+		switch (option) {
+		case 'w':
+			regress->record = optarg;
+			break;
+		case 'c':
+			regress->check = optarg;
+			break;
+		case 'W':
+			regress->recordTiming = optarg;
+			break;
+		case 'C':
+			regress->checkTiming = optarg;
+			break;
+		case 'g':
+			if (!strcmp(optarg, "all")) {
+				regress->generator = NUMBER_OF_GENERATOR;
+			} else if (findGenerator(optarg, &regress->generator)) {
+				fprintf(stderr, "Unknown generator \"%s\", use \"lal\", \"chirp\" or \"all\".\n", optarg);
+				return (FAILURE);
+			}
+			break;
+		case 'r':
+			regress->repetitions = strtoul(optarg, NULL, 10);
+			regress->repetitions = regress->repetitions ? regress->repetitions : 1;
+			break;
+		case 'm':
+			regress->matchTolerance = strtod(optarg, NULL);
+			break;
+		case 'l':
+			regress->lengthTolerance = strtod(optarg, NULL);
+			break;
+		case 'p':
+			regress->periodTolerance = strtoul(optarg, NULL, 10);
+			break;
+		case 's':
+			regress->slowdown = strtod(optarg, NULL);
+			break;
+		case 'h':
+		default:
+			printUsage(argv[0]);
+			return (FAILURE);
+		}
+	}
+	if (!regress->record && !regress->check && !regress->recordTiming && !regress->checkTiming) {
+		printUsage(argv[0]);
+		return (FAILURE);
+	}
+	return (SUCCESS);
+}
+
+/**
+ * Runs the fixed set of pairs and records or checks the results and the runtimes.
+ * @param[in] argc number of arguments
+ * @param[in] argv arguments
+ * @return	error code
+ */
+int main(int argc, char *argv[]) {
+	Regress regress;
+	if (parseArguments(argc, argv, &regress)) {
+		return (EXIT_FAILURE);
+	}
+	RegressResult *result = calloc(CASES, sizeof(RegressResult));
+	size_t count = runCases(&regress, result);
+	int failure = SUCCESS;
+	if (regress.record) {
+		failure |= recordResults(regress.record, result, count);
+	}
+	if (regress.recordTiming) {
+		failure |= recordTimes(regress.recordTiming, result, count);
+	}
+	if (regress.check) {
+		failure |= checkBaseline(&regress, regress.check, false, result, count);
+	}
+	if (regress.checkTiming) {
+		failure |= checkBaseline(&regress, regress.checkTiming, true, result, count);
+	}
+	free(result);
+	return (failure ? EXIT_FAILURE : EXIT_SUCCESS);
+}
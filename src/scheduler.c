@@ -0,0 +1,228 @@
+/**	@file   scheduler.c
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Parallel execution of independent jobs.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "scheduler.h"
+
+size_t defaultThreads(void) {
+	long processors = sysconf(_SC_NPROCESSORS_ONLN);
+	return (processors > 0 ? (size_t) processors : 1);
+}
+
+size_t startThreads(size_t threads, void *(*routine)(void *), void *argument, size_t size, pthread_t thread[]) {
+	size_t started;
+	for (started = 0; started < threads; started++) {
+		if (pthread_create(&thread[started], NULL, routine, (char *) argument + started * size)) {
+			fprintf(stderr, "Couldn't start worker thread %zu.\n", started);
+			break;
+		}
+	}
+	return (started);
+}
+
+/** Job with its estimated cost. */
+typedef struct {
+	double cost;	///< estimated cost.
+	size_t index;	///< index of the job.
+} CostedJob;
+
+static int compareCost(const void *left, const void *right) {
+	double difference = ((const CostedJob *) right)->cost - ((const CostedJob *) left)->cost;
+	return ((difference > 0.0) - (difference < 0.0));
+}
+
+/** Queue of one worker, the jobs are in decreasing cost order. */
+typedef struct {
+	CostedJob *job;	///< jobs of the queue.
+	size_t length;	///< number of the jobs.
+	size_t next;	///< position of the next job, claimed atomically by the owner and the thieves.
+} JobQueue;
+
+/** Memory budget of the running jobs. */
+typedef struct {
+	pthread_mutex_t lock;	///< protects the budget.
+	pthread_cond_t released;	///< signalled when a job finishes or is admitted.
+	double limit;	///< the budget, zero means no limit.
+	double used;	///< predicted memory of the running jobs.
+	size_t running;	///< number of the running jobs.
+	size_t ticket;	///< next ticket to hand out.
+	size_t serving;	///< ticket of the job to admit next.
+} Budget;
+
+struct Scheduler {
+	JobQueue *queue;	///< queues of the workers.
+	size_t workers;	///< number of the workers.
+	const double *memory;	///< predicted memory of the jobs.
+	Budget budget;	///< memory budget.
+};
+
+Scheduler *createScheduler(size_t length, const JobEstimate *estimate, size_t workers) {
+	Scheduler *scheduler = calloc(1, sizeof(Scheduler));
+	scheduler->workers = workers ? workers : 1;
+	scheduler->queue = calloc(scheduler->workers, sizeof(JobQueue));
+	scheduler->memory = estimate->memory;
+	pthread_mutex_init(&scheduler->budget.lock, NULL);
+	pthread_cond_init(&scheduler->budget.released, NULL);
+	scheduler->budget.limit = estimate->memory ? estimate->memoryLimit : 0.0;
+	CostedJob *sorted = malloc((length + 1) * sizeof(CostedJob));
+	for (size_t job = 0; job < length; job++) {
+		sorted[job].cost = estimate->cost[job];
+		sorted[job].index = job;
+	}
+	qsort(sorted, length, sizeof(CostedJob), compareCost);
+	for (size_t worker = 0; worker < scheduler->workers; worker++) {
+		scheduler->queue[worker].job = malloc((length / scheduler->workers + 1) * sizeof(CostedJob));
+	}
+	for (size_t job = 0; job < length; job++) {
+		JobQueue *queue = &scheduler->queue[job % scheduler->workers];
+		queue->job[queue->length++] = sorted[job];
+	}
+	free(sorted);
+	return (scheduler);
+}
+
+void destroyScheduler(Scheduler **scheduler) {
+	for (size_t worker = 0; worker < (*scheduler)->workers; worker++) {
+		free((*scheduler)->queue[worker].job);
+	}
+	free((*scheduler)->queue);
+	pthread_cond_destroy(&(*scheduler)->budget.released);
+	pthread_mutex_destroy(&(*scheduler)->budget.lock);
+	free(*scheduler);
+	*scheduler = NULL;
+}
+
+/**
+ * Claims the next job of the queue.
+ * @param[in,out] queue the queue.
+ * @param[out]    job   index of the claimed job.
+ * @return true if a job was claimed.
+ */
+static bool claimJob(JobQueue *queue, size_t *job) {
+	if (__atomic_load_n(&queue->next, __ATOMIC_RELAXED) >= queue->length) {
+		return (false);
+	}
+	size_t position = __atomic_fetch_add(&queue->next, 1, __ATOMIC_RELAXED);
+	if (position >= queue->length) {
+		return (false);
+	}
+	*job = queue->job[position].index;
+	return (true);
+}
+
+/**
+ * Steals the longest waiting job from the other queues.
+ * @param[in]  scheduler the scheduler.
+ * @param[in]  worker    the thief.
+ * @param[out] job       index of the stolen job.
+ * @return true if a job was stolen, false if every queue is empty.
+ */
+static bool stealJob(Scheduler *scheduler, size_t worker, size_t *job) {
+	for (;;) {
+		JobQueue *victim = NULL;
+		double longest = -1.0;
+		for (size_t current = 1; current < scheduler->workers; current++) {
+			JobQueue *queue = &scheduler->queue[(worker + current) % scheduler->workers];
+			size_t next = __atomic_load_n(&queue->next, __ATOMIC_RELAXED);
+			if (next < queue->length && queue->job[next].cost > longest) {
+				longest = queue->job[next].cost;
+				victim = queue;
+			}
+		}
+		if (!victim) {
+			return (false);
+		}
+		if (claimJob(victim, job)) {
+			return (true);
+		}
+	}
+}
+
+/**
+ * Waits until the job fits into the memory budget, then reserves its memory.
+ * @param[in,out] budget the budget.
+ * @param[in]     memory predicted memory of the job.
+ */
+static void admitJob(Budget *budget, double memory) {
+	pthread_mutex_lock(&budget->lock);
+	size_t ticket = budget->ticket++;
+	while (ticket != budget->serving || (budget->running && budget->used + memory > budget->limit)) {
+		pthread_cond_wait(&budget->released, &budget->lock);
+	}
+	budget->serving++;
+	budget->running++;
+	budget->used += memory;
+	pthread_cond_broadcast(&budget->released);
+	pthread_mutex_unlock(&budget->lock);
+}
+
+bool nextJob(Scheduler *scheduler, size_t worker, size_t *job) {
+	worker %= scheduler->workers;
+	if (!claimJob(&scheduler->queue[worker], job) && !stealJob(scheduler, worker, job)) {
+		return (false);
+	}
+	if (scheduler->budget.limit > 0.0) {
+		admitJob(&scheduler->budget, scheduler->memory[*job]);
+	}
+	return (true);
+}
+
+void finishJob(Scheduler *scheduler, size_t job) {
+	if (scheduler->budget.limit > 0.0) {
+		Budget *budget = &scheduler->budget;
+		pthread_mutex_lock(&budget->lock);
+		budget->used = --budget->running ? budget->used - scheduler->memory[job] : 0.0;
+		pthread_cond_broadcast(&budget->released);
+		pthread_mutex_unlock(&budget->lock);
+	}
+}
+
+/** Data of one worker thread. */
+typedef struct {
+	Scheduler *scheduler;	///< the shared scheduler.
+	size_t self;	///< index of the own queue.
+	JobRunner run;	///< executes one job.
+	void *context;	///< passed to the runner.
+} Worker;
+
+static void *work(void *argument) {
+	Worker *worker = argument;
+	size_t job;
+	while (nextJob(worker->scheduler, worker->self, &job)) {
+		worker->run(job, worker->context);
+		finishJob(worker->scheduler, job);
+	}
+	return (NULL);
+}
+
+int runJobs(size_t length, const JobEstimate *estimate, size_t threads, JobRunner run, void *context) {
+	if (threads > length) {
+		threads = length;
+	}
+	if (threads < 2) {
+		for (size_t job = 0; job < length; job++) {
+			run(job, context);
+		}
+		return (SUCCESS);
+	}
+	Scheduler *scheduler = createScheduler(length, estimate, threads);
+	pthread_t thread[threads];
+	Worker worker[threads];
+	for (size_t current = 0; current < threads; current++) {
+		worker[current] = (Worker ) { scheduler, current, run, context };
+	}
+	size_t started = startThreads(threads, work, worker, sizeof(Worker), thread);
+	if (!started) {
+		work(&worker[0]);
+	}
+	for (size_t current = 0; current < started; current++) {
+		pthread_join(thread[current], NULL);
+	}
+	destroyScheduler(&scheduler);
+	return (SUCCESS);
+}
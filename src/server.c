@@ -0,0 +1,311 @@
+/**	@file   server.c
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Long-running evaluation of the pairs requested over a socket or the standard input.
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "generator_lal.h"
+#include "pair_input.h"
+#include "server.h"
+
+/** A generated pair kept for the repeated requests. */
+typedef struct {
+	Wave pair[2];	///< parameters of the waves.
+	double initialFrequency;	///< initial frequency of the generation.
+	Variable *variable;	///< the generated values, NULL if the entry is empty.
+	size_t users;	///< number of the requests using the values.
+	uint64_t used;	///< time of the last use, the least recently used free entry is replaced.
+} CachedPair;
+
+/** State of the server. */
+static struct {
+	pthread_mutex_t lock;	///< protects the cache and the number of the connections.
+	pthread_cond_t closed;	///< signalled when a connection is closed.
+	CachedPair cache[WAVEFORM_CACHE];	///< the generated pairs.
+	uint64_t clock;	///< counter of the uses.
+	size_t connections;	///< number of the open connections.
+	int listener;	///< the listening socket, -1 when serving the standard input.
+	bool stopping;	///< shutdown was requested.
+	const JobPlan *plan;	///< the configuration.
+} server = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, .listener = -1 };
+
+static void destroyVariable(Variable *variable) {
+	destroyWaveform(&variable->wave);
+	destroyOutput(&variable);
+}
+
+/**
+ * Returns the generated pair, from the cache if it was requested recently.
+ * @param[in]  job              the pair.
+ * @param[in]  initialFrequency initial frequency.
+ * @param[in]  samplingTime     sampling time.
+ * @param[out] entry            index of the cache entry, -1 if the values are not cached.
+ * @return the generated values.
+ */
+static Variable *acquirePair(const PairJob *job, double initialFrequency, double samplingTime, int *entry) {
+	pthread_mutex_lock(&server.lock);
+	for (int current = 0; current < WAVEFORM_CACHE; current++) {
+		CachedPair *cached = &server.cache[current];
+		if (cached->variable && cached->initialFrequency == initialFrequency
+		        && !memcmp(cached->pair, job->pair, sizeof(cached->pair))) {
+			cached->users++;
+			cached->used = ++server.clock;
+			pthread_mutex_unlock(&server.lock);
+			*entry = current;
+			return (cached->variable);
+		}
+	}
+	pthread_mutex_unlock(&server.lock);
+	Wave pair[2];
+	memcpy(pair, job->pair, sizeof(pair));
+	Variable *variable = generateWaveformPair(pair, initialFrequency, samplingTime);
+	pthread_mutex_lock(&server.lock);
+	*entry = -1;
+	for (int current = 0; current < WAVEFORM_CACHE; current++) {
+		CachedPair *cached = &server.cache[current];
+		if (!cached->users && (*entry < 0 || cached->used < server.cache[*entry].used)) {
+			*entry = current;
+		}
+	}
+	if (*entry >= 0) {
+		CachedPair *cached = &server.cache[*entry];
+		if (cached->variable) {
+			destroyVariable(cached->variable);
+		}
+		memcpy(cached->pair, job->pair, sizeof(cached->pair));
+		cached->initialFrequency = initialFrequency;
+		cached->variable = variable;
+		cached->users = 1;
+		cached->used = ++server.clock;
+	}
+	pthread_mutex_unlock(&server.lock);
+	return (variable);
+}
+
+static void releasePair(Variable *variable, int entry) {
+	if (entry < 0) {
+		destroyVariable(variable);
+		return;
+	}
+	pthread_mutex_lock(&server.lock);
+	server.cache[entry].users--;
+	pthread_mutex_unlock(&server.lock);
+}
+
+/**
+ * Evaluates the request and prints the response.
+ * @param[in] line   the request, modified.
+ * @param[in] output where to respond.
+ */
+static void answer(char *line, FILE *output) {
+	PairRecord record;
+	if (parsePairLine(line, &record)) {
+		fprintf(output, "- error malformed request\n");
+		return;
+	}
+	PairJob job;
+	Parameter band;
+	fillPairJob(&record, server.plan, &job, &band);
+	int entry;
+	Variable *variable = acquirePair(&job, band.initialFrequency, band.samplingTime, &entry);
+	if (!variable->length[FIRST_WAVE] || !variable->length[SECOND_WAVE]) {
+		releasePair(variable, entry);
+		fprintf(output, "%s error generation failed\n", job.name);
+		return;
+	}
+	Analysed analysed;
+	size_t minIndex, maxIndex;
+	initMatch(variable->wave);
+	generatePSD(band.initialFrequency, band.samplingFrequency);
+	indexFromFrequency(band.initialFrequency, band.endingFrequency, band.samplingFrequency / variable->size,
+	        &minIndex, &maxIndex);
+	calcMatches(minIndex, maxIndex, &analysed);
+	countPeriods(band.samplingTime, &analysed);
+	cleanMatch();
+	releasePair(variable, entry);
+	fprintf(output, "%s %.16g %.16g %.16g %zu %zu %.16g %.16g %.16g %.16g\n", job.name, analysed.match[WORST],
+	        analysed.match[TYPICAL], analysed.match[BEST], analysed.period[FIRST_WAVE],
+	        analysed.period[SECOND_WAVE], analysed.relativePeriod, analysed.length[FIRST_WAVE],
+	        analysed.length[SECOND_WAVE], analysed.relativeLength);
+}
+
+/**
+ * Answers the requests of a connection in order.
+ * @param[in] input  the requests.
+ * @param[in] output the responses.
+ */
+static void serveStream(FILE *input, FILE *output) {
+	char *line = NULL;
+	size_t size = 0;
+	while (getline(&line, &size, input) >= 0) {
+		char *request = line + strspn(line, " \t");
+		request[strcspn(request, "\r\n")] = '\0';
+		if (!*request || *request == '#') {
+			continue;
+		}
+		if (!strcmp(request, "quit")) {
+			break;
+		}
+		if (!strcmp(request, "shutdown")) {
+			pthread_mutex_lock(&server.lock);
+			server.stopping = true;
+			if (server.listener >= 0) {
+				shutdown(server.listener, SHUT_RDWR);
+			}
+			pthread_mutex_unlock(&server.lock);
+			break;
+		}
+		answer(request, output);
+		fflush(output);
+	}
+	free(line);
+}
+
+static void *serveConnection(void *argument) {
+	int descriptor = (int) (intptr_t) argument;
+	FILE *input = fdopen(descriptor, "r");
+	FILE *output = fdopen(dup(descriptor), "w");
+	if (input && output) {
+		serveStream(input, output);
+	}
+	if (output) {
+		fclose(output);
+	}
+	if (input) {
+		fclose(input);
+	} else {
+		close(descriptor);
+	}
+	releaseMatchCache();
+	pthread_mutex_lock(&server.lock);
+	server.connections--;
+	pthread_cond_broadcast(&server.closed);
+	pthread_mutex_unlock(&server.lock);
+	return (NULL);
+}
+
+/**
+ * Removes the socket file, any other kind of file is kept.
+ * @param[in] path path of the socket.
+ * @return failure code, SUCCESS if the path doesn't exist.
+ */
+static int removeSocket(const char *path) {
+	struct stat status;
+	if (lstat(path, &status)) {
+		if (errno == ENOENT) {
+			return (SUCCESS);
+		}
+		fprintf(stderr, "Couldn't check %s; %s\n", path, strerror(errno));
+		return (FAILURE);
+	}
+	if (!S_ISSOCK(status.st_mode)) {
+		fprintf(stderr, "%s exists and is not a socket, it is not removed.\n", path);
+		return (FAILURE);
+	}
+	if (unlink(path)) {
+		fprintf(stderr, "Couldn't remove %s; %s\n", path, strerror(errno));
+		return (FAILURE);
+	}
+	return (SUCCESS);
+}
+
+/**
+ * Opens the listening socket, a stale socket of the path is replaced.
+ * @param[in] path path of the socket.
+ * @return the socket or -1 on error.
+ */
+static int openListener(const char *path) {
+	struct sockaddr_un address = { .sun_family = AF_UNIX };
+	if (strlen(path) >= sizeof(address.sun_path)) {
+		fprintf(stderr, "Socket path %s is too long.\n", path);
+		return (-1);
+	}
+	strcpy(address.sun_path, path);
+	int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listener < 0) {
+		fprintf(stderr, "Couldn't create socket; %s\n", strerror(errno));
+		return (-1);
+	}
+	if (removeSocket(path)) {
+		close(listener);
+		return (-1);
+	}
+	if (bind(listener, (struct sockaddr *) &address, sizeof(address)) || listen(listener, SOMAXCONN)) {
+		fprintf(stderr, "Couldn't listen on %s; %s\n", path, strerror(errno));
+		close(listener);
+		return (-1);
+	}
+	return (listener);
+}
+
+int runServer(const char *path, const JobPlan *plan) {
+	server.plan = plan;
+	matchCacheEnabled = true;
+	signal(SIGPIPE, SIG_IGN);
+	if (!strcmp(path, "-")) {
+		serveStream(stdin, stdout);
+		releaseMatchCache();
+		return (SUCCESS);
+	}
+	int listener = openListener(path);
+	if (listener < 0) {
+		return (FAILURE);
+	}
+	server.listener = listener;
+	fprintf(stderr, "Listening on %s\n", path);
+	int failure = SUCCESS;
+	for (;;) {
+		int descriptor = accept(listener, NULL, NULL);
+		if (descriptor < 0) {
+			if (errno == EINTR || errno == ECONNABORTED) {
+				continue;
+			}
+			pthread_mutex_lock(&server.lock);
+			if (!server.stopping) {
+				fprintf(stderr, "Couldn't accept connection; %s\n", strerror(errno));
+				failure = FAILURE;
+			}
+			pthread_mutex_unlock(&server.lock);
+			break;
+		}
+		pthread_t thread;
+		pthread_mutex_lock(&server.lock);
+		server.connections++;
+		pthread_mutex_unlock(&server.lock);
+		if (pthread_create(&thread, NULL, serveConnection, (void *) (intptr_t) descriptor)) {
+			fprintf(stderr, "Couldn't start the thread of a connection.\n");
+			close(descriptor);
+			pthread_mutex_lock(&server.lock);
+			server.connections--;
+			pthread_mutex_unlock(&server.lock);
+			continue;
+		}
+		pthread_detach(thread);
+	}
+	pthread_mutex_lock(&server.lock);
+	while (server.connections) {
+		pthread_cond_wait(&server.closed, &server.lock);
+	}
+	server.listener = -1;
+	pthread_mutex_unlock(&server.lock);
+	close(listener);
+	failure |= removeSocket(path);
+	for (int current = 0; current < WAVEFORM_CACHE; current++) {
+		if (server.cache[current].variable) {
+			destroyVariable(server.cache[current].variable);
+			server.cache[current].variable = NULL;
+		}
+	}
+	return (failure);
+}
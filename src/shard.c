@@ -0,0 +1,220 @@
+/**	@file   shard.c
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Splitting a run into independent shards and merging their outputs.
+ */
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "shard.h"
+#include "util_IO.h"
+
+#define SHARD_FORMAT "shard_%zu_of_%zu"
+
+int parseShard(const char *text, Shard *shard) {
+	char rest;
+	if (sscanf(text, "%zu/%zu%c", &shard->index, &shard->count, &rest) != 2 || shard->count == 0
+	        || shard->index >= shard->count) {
+		fprintf(stderr, "Invalid shard \"%s\", expected i/N with 0 <= i < N.\n", text);
+		return (FAILURE);
+	}
+	return (SUCCESS);
+}
+
+bool isInShard(const Shard *shard, size_t index) {
+	return (shard->count < 2 || index % shard->count == shard->index);
+}
+
+int initShardDirectory(char *outputDir, size_t capacity, const Shard *shard) {
+	if (shard->count < 2) {
+		return (SUCCESS);
+	}
+	char directory[FILENAME_MAX];
+	int length = snprintf(directory, sizeof(directory), "%s/" SHARD_FORMAT, outputDir, shard->index, shard->count);
+	if (length < 0 || (size_t) length >= capacity || (size_t) length >= sizeof(directory)) {
+		fprintf(stderr, "The shard directory of %s is too long.\n", outputDir);
+		return (FAILURE);
+	}
+	mkdir(directory, S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+	memcpy(outputDir, directory, (size_t) length + 1);
+	return (SUCCESS);
+}
+
+/** Line source of a shard file. */
+typedef struct {
+	FILE *file;	///< the opened shard file.
+	char *line;	///< next data line, NULL at the end of the file.
+	size_t size;	///< allocated size of the line.
+} ShardFile;
+
+static void readDataLine(ShardFile *shard) {
+	if (getline(&shard->line, &shard->size, shard->file) < 0) {
+		free(shard->line);
+		shard->line = NULL;
+		shard->size = 0;
+	}
+}
+
+/**
+ * Writes the header of the first shard, then the data lines in the round-robin order of isInShard().
+ * @param[out] out   merged file.
+ * @param[in]  shard shard files containing the same output.
+ * @param[in]  count number of the shard files.
+ * @return failure code
+ */
+static int mergeLines(FILE *out, ShardFile shard[], size_t count) {
+	for (size_t current = 0; current < count; current++) {
+		readDataLine(&shard[current]);
+		while (shard[current].line && shard[current].line[0] == '#') {
+			if (current == 0) {
+				fputs(shard[current].line, out);
+			}
+			readDataLine(&shard[current]);
+		}
+	}
+	size_t current = 0;
+	while (shard[current].line) {
+		fputs(shard[current].line, out);
+		readDataLine(&shard[current]);
+		current = (current + 1) % count;
+	}
+	int failure = SUCCESS;
+	for (current = 0; current < count; current++) {
+		if (shard[current].line) {
+			failure = FAILURE;
+			free(shard[current].line);
+		}
+	}
+	return (failure);
+}
+
+/**
+ * Copies the file of a single shard unchanged, it may be a binary dump.
+ * @param[out] out   the copy.
+ * @param[in]  in    the shard file.
+ * @return failure code
+ */
+static int copyFile(FILE *out, FILE *in) {
+	char buffer[BUFSIZ];
+	size_t length;
+	while ((length = fread(buffer, 1, sizeof(buffer), in))) {
+		if (fwrite(buffer, 1, length, out) != length) {
+			return (FAILURE);
+		}
+	}
+	return (ferror(in) ? FAILURE : SUCCESS);
+}
+
+/** Output files found in the shard directories. */
+typedef struct {
+	size_t length;	///< number of the files.
+	char (*name)[FILENAME_MAX];	///< names of the files.
+	size_t *owners;	///< number of the shards containing the file.
+	size_t *owner;	///< last shard containing the file.
+} ShardListing;
+
+static void addFile(ShardListing *listing, const char *name, size_t shard) {
+	for (size_t current = 0; current < listing->length; current++) {
+		if (!strcmp(listing->name[current], name)) {
+			listing->owners[current]++;
+			listing->owner[current] = shard;
+			return;
+		}
+	}
+	listing->name = realloc(listing->name, (listing->length + 1) * sizeof(*listing->name));
+	listing->owners = realloc(listing->owners, (listing->length + 1) * sizeof(size_t));
+	listing->owner = realloc(listing->owner, (listing->length + 1) * sizeof(size_t));
+	strcpy(listing->name[listing->length], name);
+	listing->owners[listing->length] = 1;
+	listing->owner[listing->length] = shard;
+	listing->length++;
+}
+
+static int listShards(const char *outputDir, size_t *count) {
+	DIR *directory = opendir(outputDir);
+	if (!directory) {
+		fprintf(stderr, "Couldn't open the output directory %s.\n", outputDir);
+		return (FAILURE);
+	}
+	size_t index, number, found = 0;
+	*count = 0;
+	struct dirent *entry;
+	while ((entry = readdir(directory))) {
+		char rest;
+		if (sscanf(entry->d_name, SHARD_FORMAT "%c", &index, &number, &rest) == 2) {
+			if (*count && *count != number) {
+				fprintf(stderr, "Shards of different runs in %s.\n", outputDir);
+				closedir(directory);
+				return (FAILURE);
+			}
+			*count = number;
+			found++;
+		}
+	}
+	closedir(directory);
+	if (!*count || found != *count) {
+		fprintf(stderr, "Found %zu of %zu shards in %s.\n", found, *count, outputDir);
+		return (FAILURE);
+	}
+	return (SUCCESS);
+}
+
+int mergeShards(const char *outputDir) {
+	size_t count;
+	if (listShards(outputDir, &count)) {
+		return (FAILURE);
+	}
+	ShardListing listing;
+	memset(&listing, 0, sizeof(ShardListing));
+	char path[FILENAME_MAX];
+	for (size_t current = 0; current < count; current++) {
+		sprintf(path, "%s/" SHARD_FORMAT, outputDir, current, count);
+		DIR *directory = opendir(path);
+		if (!directory) {
+			fprintf(stderr, "Couldn't open the shard directory %s.\n", path);
+			return (FAILURE);
+		}
+		struct dirent *entry;
+		while ((entry = readdir(directory))) {
+			if (entry->d_name[0] != '.') {
+				addFile(&listing, entry->d_name, current);
+			}
+		}
+		closedir(directory);
+	}
+	int failure = SUCCESS;
+	ShardFile shard[count];
+	for (size_t file = 0; file < listing.length; file++) {
+		size_t first = listing.owner[file], number = 1;
+		if (listing.owners[file] == count) {
+			first = 0;
+			number = count;
+		} else if (listing.owners[file] != 1) {
+			fprintf(stderr, "%s is missing from some of the shards.\n", listing.name[file]);
+			failure = FAILURE;
+			continue;
+		}
+		memset(shard, 0, sizeof(shard));
+		for (size_t current = 0; current < number; current++) {
+			sprintf(path, "%s/" SHARD_FORMAT "/%s", outputDir, first + current, count, listing.name[file]);
+			shard[current].file = safelyOpenForReading(path);
+		}
+		sprintf(path, "%s/%s", outputDir, listing.name[file]);
+		FILE *out = safelyOpenForWriting(path);
+		if (number == 1 ? copyFile(out, shard[0].file) : mergeLines(out, shard, number)) {
+			fprintf(stderr, "The shards of %s are inconsistent.\n", listing.name[file]);
+			failure = FAILURE;
+		}
+		fclose(out);
+		for (size_t current = 0; current < number; current++) {
+			fclose(shard[current].file);
+		}
+	}
+	free(listing.name);
+	free(listing.owners);
+	free(listing.owner);
+	return (failure);
+}
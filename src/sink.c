@@ -0,0 +1,93 @@
+/**	@file   sink.c
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Destinations of the results of the exact pairs.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "sink.h"
+
+/**
+ * Dumps the spins, the orbital planes and the waveforms of the pair into three files.
+ */
+static void dumpPair(Sink *sink, const char *name, Variable *variable, Wave pair[], Analysed *analysed) {
+	const Parameter *parameter = sink->parameter;
+	string path;
+	for (int kind = SPIN_DUMP; kind < NUMBER_OF_DUMP; kind++) {
+		sprintf(path, "%s/%s_%s.%s", sink->outputDir, name, getDumpName(kind), getDumpExtension(parameter->format));
+		DumpSamples samples;
+		selectSamples(&samples, &parameter->dump[kind], variable, parameter->samplingTime);
+		Writer *file = openWriter(path, sink->mode);
+		if (parameter->format == BINARY_FORMAT) {
+			printBinary(file, kind, variable, pair, analysed, &samples);
+		} else {
+			printText(file, kind, variable, pair, analysed, &samples);
+		}
+		closeWriter(&file);
+		releaseSamples(&samples);
+	}
+}
+
+/** Format of the numbers of the summary, the same as "%16.10g". */
+static const OutputFormat summaryFormat = { 10, 16, 16 + SEPARATOR_LENGTH, 'g', ' ', false, "%16.10lg", "%16s" };
+
+/**
+ * Writes one row of the results of the pair into the summary file.
+ */
+static void summarisePair(Sink *sink, const char *name, Analysed *analysed) {
+	double match[] = { analysed->match[WORST], analysed->match[TYPICAL], analysed->match[BEST] };
+	double remaining[] = { analysed->relativePeriod, analysed->length[FIRST_WAVE], analysed->length[SECOND_WAVE],
+	        analysed->relativeLength };
+	writeFormatted(sink->summary, "%-16s ", name);
+	writeDoubles(sink->summary, match, sizeof(match) / sizeof(match[0]), &summaryFormat, ' ');
+	writeFormatted(sink->summary, "%10zu %10zu ", analysed->period[FIRST_WAVE], analysed->period[SECOND_WAVE]);
+	writeDoubles(sink->summary, remaining, sizeof(remaining) / sizeof(remaining[0]), &summaryFormat, '\n');
+}
+
+/**
+ * Prints the matches, periods and lengths of the pair to the standard output.
+ */
+static void reportPair(Sink *sink, const char *name, Analysed *analysed) {
+	(void) sink;
+	(void) name;
+	printf("w:%g t:%g b:%g\n%zu %zu %g%%\n%g %g %g%%\n", analysed->match[WORST], analysed->match[TYPICAL],
+	        analysed->match[BEST], analysed->period[FIRST_WAVE], analysed->period[SECOND_WAVE],
+	        analysed->relativePeriod * 100.0, analysed->length[FIRST_WAVE], analysed->length[SECOND_WAVE],
+	        analysed->relativeLength * 100.0);
+}
+
+Sink *openSink(const Parameter *parameter, const char *outputDir, WriterMode mode) {
+	Sink *sink = calloc(1, sizeof(Sink));
+	sink->parameter = parameter;
+	sink->outputDir = outputDir;
+	sink->mode = mode;
+	switch (parameter->sink) {
+	case FULL_SINK:
+		sink->dump = dumpPair;
+		sink->report = reportPair;
+		break;
+	case SUMMARY_SINK: {
+		string path;
+		sprintf(path, "%s/summary.data", outputDir);
+		sink->summary = openWriter(path, mode);
+		sink->summarise = summarisePair;
+		sink->report = reportPair;
+		writeFormatted(sink->summary, "#%-15s %16s %16s %16s %10s %10s %16s %16s %16s %16s\n", "name", "worst",
+		        "typical", "best", "period1", "period2", "relPeriod", "length1", "length2", "relLength");
+		break;
+	}
+	case NULL_SINK:
+	default:
+		break;
+	}
+	return (sink);
+}
+
+void closeSink(Sink **sink) {
+	if ((*sink)->summary) {
+		closeWriter(&(*sink)->summary);
+	}
+	free(*sink);
+	*sink = NULL;
+}
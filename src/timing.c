@@ -0,0 +1,162 @@
+/**	@file   timing.c
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Timing of the stages of the jobs.
+ */
+
+#include "timing.h"
+
+enum {
+	LENGTH_BUCKETS = 40,	///< number of the power of two buckets of the lengths.
+	SUB_BINS = 4,	///< number of the bins per power of two of the durations.
+	DURATION_BINS = 160,	///< number of the bins of the durations, up to about 18 minutes.
+};
+
+/** Durations of a stage for a bucket of lengths. */
+typedef struct {
+	uint64_t count;	///< number of the measurements.
+	uint64_t total;	///< sum of the durations in nanoseconds.
+	uint64_t maximum;	///< the longest duration.
+	uint64_t bin[DURATION_BINS];	///< number of the durations per logarithmic bin.
+} Histogram;
+
+bool timingEnabled = false;
+
+static Histogram histogram[NUMBER_OF_STAGE][LENGTH_BUCKETS];	///< updated atomically by the workers.
+
+static const char *stageName[NUMBER_OF_STAGE] = { "generation", "fill", "plan", "psd", "forward", "product",
+	"inverse", "matches", "output" };
+
+const char *getStageName(TimingStage stage) {
+	return (stageName[stage]);
+}
+
+static unsigned highestBit(uint64_t value) {
+	return (63u - (unsigned) __builtin_clzll(value));
+}
+
+static size_t getLengthBucket(size_t length) {
+	size_t bucket = length ? highestBit(length) : 0;
+	return (bucket < LENGTH_BUCKETS ? bucket : LENGTH_BUCKETS - 1);
+}
+
+/**
+ * Returns the bin of the duration, the bins below SUB_BINS are exact, above each power of two is
+ * split into SUB_BINS equal parts.
+ * @param[in] duration the duration in nanoseconds.
+ * @return index of the bin.
+ */
+static size_t getDurationBin(uint64_t duration) {
+	if (duration < SUB_BINS) {
+		return (duration);
+	}
+	unsigned exponent = highestBit(duration);
+	size_t bin = (exponent - 1) * SUB_BINS + ((duration >> (exponent - 2)) & (SUB_BINS - 1));
+	return (bin < DURATION_BINS ? bin : DURATION_BINS - 1);
+}
+
+/**
+ * Returns the upper limit of the bin.
+ * @param[in] bin index of the bin.
+ * @return the largest duration of the bin.
+ */
+static uint64_t getBinLimit(size_t bin) {
+	if (bin < SUB_BINS) {
+		return (bin);
+	}
+	unsigned exponent = bin / SUB_BINS + 1;
+	return ((((uint64_t) SUB_BINS + bin % SUB_BINS + 1) << (exponent - 2)) - 1);
+}
+
+void recordDuration(TimingStage stage, size_t length, uint64_t duration) {
+	Histogram *current = &histogram[stage][getLengthBucket(length)];
+	__atomic_fetch_add(&current->count, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&current->total, duration, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&current->bin[getDurationBin(duration)], 1, __ATOMIC_RELAXED);
+	uint64_t maximum = __atomic_load_n(&current->maximum, __ATOMIC_RELAXED);
+	while (duration > maximum && !__atomic_compare_exchange_n(&current->maximum, &maximum, duration, true,
+	        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+	}
+}
+
+uint64_t finishTiming(TimingStage stage, size_t length, uint64_t start) {
+	uint64_t end = readClock();
+	if (timingEnabled) {
+		recordDuration(stage, length, end - start);
+	}
+	if (tracingEnabled) {
+		traceSpan(stageName[stage], start, end, length);
+	}
+	return (end);
+}
+
+/**
+ * Returns the quantile of the durations with the resolution of the bins.
+ * @param[in] current  the histogram.
+ * @param[in] quantile the quantile between zero and one.
+ * @return the duration in nanoseconds.
+ */
+static uint64_t getQuantile(const Histogram *current, double quantile) {
+	uint64_t rank = (uint64_t) (quantile * current->count + 0.5), seen = 0;
+	rank = rank ? rank : 1;
+	for (size_t bin = 0; bin < DURATION_BINS; bin++) {
+		seen += current->bin[bin];
+		if (seen >= rank) {
+			uint64_t limit = getBinLimit(bin);
+			return (limit < current->maximum ? limit : current->maximum);
+		}
+	}
+	return (current->maximum);
+}
+
+/** Summary of a histogram in seconds. */
+typedef struct {
+	uint64_t count;	///< number of the measurements.
+	double total;	///< sum of the durations.
+	double median;	///< the median.
+	double high;	///< the 95th percentile.
+	double maximum;	///< the longest duration.
+} TimingSummary;
+
+static void summarise(const Histogram *current, TimingSummary *summary) {
+	summary->count = current->count;
+	summary->total = current->total * 1e-9;
+	summary->median = getQuantile(current, 0.5) * 1e-9;
+	summary->high = getQuantile(current, 0.95) * 1e-9;
+	summary->maximum = current->maximum * 1e-9;
+}
+
+void printTimingReport(FILE *file) {
+	fprintf(file, "#%-11s %12s %10s %12s %12s %12s %12s\n", "stage", "length>=", "count", "total[s]", "p50[s]",
+	        "p95[s]", "max[s]");
+	for (int stage = GENERATION_STAGE; stage < NUMBER_OF_STAGE; stage++) {
+		for (size_t bucket = 0; bucket < LENGTH_BUCKETS; bucket++) {
+			TimingSummary summary;
+			summarise(&histogram[stage][bucket], &summary);
+			if (summary.count) {
+				fprintf(file, "%-12s %12zu %10llu %12.6g %12.6g %12.6g %12.6g\n", stageName[stage],
+				        (size_t) 1 << bucket, (unsigned long long) summary.count, summary.total, summary.median,
+				        summary.high, summary.maximum);
+			}
+		}
+	}
+}
+
+void writeTimingJSON(FILE *file) {
+	fputs("{\n  \"stages\": [", file);
+	const char *separator = "\n";
+	for (int stage = GENERATION_STAGE; stage < NUMBER_OF_STAGE; stage++) {
+		for (size_t bucket = 0; bucket < LENGTH_BUCKETS; bucket++) {
+			TimingSummary summary;
+			summarise(&histogram[stage][bucket], &summary);
+			if (summary.count) {
+				fprintf(file, "%s    { \"stage\": \"%s\", \"minLength\": %zu, \"maxLength\": %zu, \"count\": %llu, "
+				        "\"total\": %.9g, \"p50\": %.9g, \"p95\": %.9g, \"max\": %.9g }", separator, stageName[stage],
+				        (size_t) 1 << bucket, ((size_t) 2 << bucket) - 1, (unsigned long long) summary.count,
+				        summary.total, summary.median, summary.high, summary.maximum);
+				separator = ",\n";
+			}
+		}
+	}
+	fputs("\n  ]\n}\n", file);
+}
@@ -0,0 +1,155 @@
+/**	@file   trace.c
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Recording of the stages of the jobs in the Chrome trace format.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "trace.h"
+
+enum {
+	TRACE_CAPACITY = 1 << 15,	///< number of the spans kept per thread, a power of two.
+	TRACE_NAME = 32,	///< length of the name of a thread.
+	NO_JOB = -1,	///< the span belongs to no job.
+};
+
+/** A recorded span. */
+typedef struct {
+	const char *name;	///< name of the span.
+	uint64_t begin;	///< start in nanoseconds.
+	uint64_t end;	///< end in nanoseconds.
+	uint64_t length;	///< length of the processed waveform.
+	int64_t job;	///< index of the job or NO_JOB.
+	double mass[2];	///< masses of the job.
+} TraceSpan;
+
+typedef struct TraceBuffer TraceBuffer;
+
+/** Ring buffer of a thread, written only by its thread. */
+struct TraceBuffer {
+	TraceBuffer *next;	///< the buffer of the previously registered thread.
+	size_t thread;	///< identifier of the thread in the trace.
+	char name[TRACE_NAME];	///< name of the thread.
+	int64_t job;	///< the current job of the thread.
+	double mass[2];	///< masses of the current job.
+	size_t head;	///< number of the recorded spans.
+	TraceSpan span[TRACE_CAPACITY];	///< the latest spans.
+};
+
+bool tracingEnabled = false;
+
+static TraceBuffer *buffers = NULL;	///< the registered buffers, pushed with compare-and-swap.
+static size_t threads = 0;	///< number of the registered threads.
+static __thread TraceBuffer *own = NULL;	///< buffer of the calling thread.
+
+/**
+ * Returns the buffer of the calling thread, registers it at the first call.
+ * @return the buffer or NULL if it couldn't be allocated.
+ */
+static TraceBuffer *getBuffer(void) {
+	if (!own) {
+		own = calloc(1, sizeof(TraceBuffer));
+		if (!own) {
+			return (NULL);
+		}
+		own->thread = __atomic_fetch_add(&threads, 1, __ATOMIC_RELAXED) + 1;
+		own->job = NO_JOB;
+		sprintf(own->name, "thread %zu", own->thread);
+		own->next = __atomic_load_n(&buffers, __ATOMIC_RELAXED);
+		while (!__atomic_compare_exchange_n(&buffers, &own->next, own, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+		}
+	}
+	return (own);
+}
+
+void nameTraceThread(const char *role, size_t index) {
+	TraceBuffer *buffer = tracingEnabled ? getBuffer() : NULL;
+	if (buffer) {
+		snprintf(buffer->name, TRACE_NAME, "%s %zu", role, index);
+	}
+}
+
+void setTraceJob(size_t job, const double mass[2]) {
+	TraceBuffer *buffer = tracingEnabled ? getBuffer() : NULL;
+	if (buffer) {
+		buffer->job = (int64_t) job;
+		buffer->mass[0] = mass[0];
+		buffer->mass[1] = mass[1];
+	}
+}
+
+void traceSpan(const char *name, uint64_t begin, uint64_t end, size_t length) {
+	TraceBuffer *buffer = getBuffer();
+	if (buffer) {
+		TraceSpan *span = &buffer->span[buffer->head & (TRACE_CAPACITY - 1)];
+		*span = (TraceSpan ) { name, begin, end, length, buffer->job, { buffer->mass[0], buffer->mass[1] } };
+		__atomic_store_n(&buffer->head, buffer->head + 1, __ATOMIC_RELEASE);
+	}
+}
+
+/**
+ * Writes the begin or the end event of the span.
+ * @param[in] file   where to write.
+ * @param[in] buffer the buffer of the thread.
+ * @param[in] span   the span.
+ * @param[in] begin  writes the begin event if true, the end event otherwise.
+ * @param[in] origin the earliest recorded time.
+ */
+static void writeEvent(FILE *file, const TraceBuffer *buffer, const TraceSpan *span, bool begin, uint64_t origin) {
+	double time = ((begin ? span->begin : span->end) - origin) * 1e-3;
+	fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"stage\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%zu", span->name,
+	        begin ? 'B' : 'E', time, buffer->thread);
+	if (begin && span->job != NO_JOB) {
+		fprintf(file, ",\"args\":{\"job\":%lld,\"m1\":%g,\"m2\":%g,\"length\":%llu}", (long long) span->job,
+		        span->mass[0], span->mass[1], (unsigned long long) span->length);
+	} else if (begin) {
+		fprintf(file, ",\"args\":{\"length\":%llu}", (unsigned long long) span->length);
+	}
+	fputc('}', file);
+}
+
+/**
+ * Returns the index of the oldest kept span.
+ * @param[in] head number of the recorded spans.
+ * @return the index.
+ */
+static size_t getOldest(size_t head) {
+	return (head > TRACE_CAPACITY ? head - TRACE_CAPACITY : 0);
+}
+
+int writeTrace(const char *path) {
+	FILE *file = fopen(path, "w");
+	if (!file) {
+		fprintf(stderr, "Couldn't open file %s for writing.\n", path);
+		return (FAILURE);
+	}
+	uint64_t origin = UINT64_MAX;
+	TraceBuffer *first = __atomic_load_n(&buffers, __ATOMIC_ACQUIRE);
+	for (TraceBuffer *buffer = first; buffer; buffer = buffer->next) {
+		size_t head = __atomic_load_n(&buffer->head, __ATOMIC_ACQUIRE);
+		for (size_t current = getOldest(head); current < head; current++) {
+			uint64_t begin = buffer->span[current & (TRACE_CAPACITY - 1)].begin;
+			origin = begin < origin ? begin : origin;
+		}
+	}
+	fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+	        "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"match\"}}", file);
+	for (TraceBuffer *buffer = first; buffer; buffer = buffer->next) {
+		fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%zu,\"args\":{\"name\":\"%s\"}}",
+		        buffer->thread, buffer->name);
+		size_t head = __atomic_load_n(&buffer->head, __ATOMIC_ACQUIRE);
+		for (size_t current = getOldest(head); current < head; current++) {
+			const TraceSpan *span = &buffer->span[current & (TRACE_CAPACITY - 1)];
+			writeEvent(file, buffer, span, true, origin);
+			writeEvent(file, buffer, span, false, origin);
+		}
+	}
+	fputs("\n]}\n", file);
+	if (fclose(file)) {
+		fprintf(stderr, "Couldn't write file %s.\n", path);
+		return (FAILURE);
+	}
+	return (SUCCESS);
+}
@@ -8,6 +8,9 @@
 
 #include "test.h"
 #include <errno.h>
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
@@ -124,25 +127,31 @@ void setOutputFormat(OutputFormat *format, const ushort precision, const ushort
 	SAVE_FUNCTION_FOR_TESTING();
 }
 
-static void setFormats(char formatString[], const ushort number, OutputFormat *format) {
+/**	Appends the separator and the format of one number to the end of the format string.
+ * @param[in]	end		: end of the format string
+ * @param[in]	format	: the format
+ * @return	the new end of the format string
+ */
+static char *appendFormat(char *end, OutputFormat *format) {
+	*end++ = ' ';
+	if (format->separator == '%') {
+		*end++ = '%';
+	}
+	*end++ = format->separator;
+	*end++ = ' ';
+	return (stpcpy(end, format->oneNumber));
+}
+
+static char *setFormats(char formatString[], const ushort number, OutputFormat *format) {
 	BACKUP_DEFINITION_LINE(); //
 	assert(formatString);
 	assert(number);
 	assert(format);
-	ushort length = (ushort) (number * format->widthWithSeparator);
-	char temp[length];
-	strcpy(formatString, format->oneNumber);
-	if (format->separator == '%') {
-		for (ushort i = 1; i < number; i++) {
-			sprintf(temp, "%s %%%c %s", formatString, format->separator, format->oneNumber);
-			strcpy(formatString, temp);
-		}
-	} else {
-		for (ushort i = 1; i < number; i++) {
-			sprintf(temp, "%s %c %s", formatString, format->separator, format->oneNumber);
-			strcpy(formatString, temp);
-		}
+	char *end = stpcpy(formatString, format->oneNumber);
+	for (ushort i = 1; i < number; i++) {
+		end = appendFormat(end, format);
 	}; SAVE_FUNCTION_FOR_TESTING();
+	return (end);
 }
 
 void setFormat(char formatString[], const ushort number, OutputFormat *format) {
@@ -150,14 +159,13 @@ void setFormat(char formatString[], const ushort number, OutputFormat *format) {
 	assert(formatString);
 	assert(number);
 	assert(format);
-	setFormats(formatString, number, format);
-	char temp[number * format->widthWithSeparator];
-	strcpy(temp, formatString);
+	char *end = setFormats(formatString, number, format);
+	*end++ = ' ';
 	if (format->separator == '%') {
-		sprintf(formatString, "%s %%%c", temp, format->separator);
-	} else {
-		sprintf(formatString, "%s %c", temp, format->separator);
-	} //
+		*end++ = '%';
+	}
+	*end++ = format->separator;
+	*end = '\0';
 	SAVE_FUNCTION_FOR_TESTING();
 }
 
@@ -166,14 +174,255 @@ void setFormatEnd(char formatString[], const ushort number, OutputFormat *format
 	assert(formatString);
 	assert(number);
 	assert(format);
-	setFormats(formatString, number, format);
-	ushort length = (ushort) (number * format->widthWithSeparator);
-	char temp[length];
-	strcpy(temp, formatString);
-	sprintf(formatString, "%s\n", temp);
+	strcpy(setFormats(formatString, number, format), "\n");
 	SAVE_FUNCTION_FOR_TESTING();
 }
 
+/// @name Number formatting
+///@{
+
+/** Constants of the number formatting.
+ */
+enum {
+	FAST_DIGITS = 17,	///< maximal number of the digits of the fast conversion
+	FAST_LENGTH = 48,	///< maximal length of a number of the fast conversion
+	POWERS = 28,	///< number of the exact powers of ten in long double
+	ROUNDING_ULPS = 64,	///< uncertainty of the scaling in units of the last place
+};
+
+static const long double powerOfTen[POWERS] = { 1e0L, 1e1L, 1e2L, 1e3L, 1e4L, 1e5L, 1e6L, 1e7L, 1e8L, 1e9L, 1e10L,
+	1e11L, 1e12L, 1e13L, 1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L, 1e20L, 1e21L, 1e22L, 1e23L, 1e24L, 1e25L, 1e26L,
+	1e27L, };
+
+static const uint64_t digitLimit[FAST_DIGITS + 2] = { 1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull,
+	10000000ull, 100000000ull, 1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull,
+	100000000000000ull, 1000000000000000ull, 10000000000000000ull, 100000000000000000ull, 1000000000000000000ull, };
+
+/**	Multiplies the value with the power of ten.
+ * @param[in]	value		: the value
+ * @param[in]	exponent	: the exponent of ten
+ * @return	the scaled value
+ */
+static long double scaleByTen(double value, int exponent) {
+	if (exponent >= 0 && exponent < POWERS) {
+		return (value * powerOfTen[exponent]);
+	} else if (exponent < 0 && -exponent < POWERS) {
+		return (value / powerOfTen[-exponent]);
+	}
+	return (value * powl(10.0L, exponent));
+}
+
+/**	Rounds the scaled value to the nearest integer. It fails if the value is too close to the halfway
+ * point to decide the direction with the precision of the scaling, then printf has to do it.
+ * @param[in]	scaled	: the scaled value
+ * @param[out]	digits	: the rounded value
+ * @return	true if the rounding is certain
+ */
+static bool roundScaled(long double scaled, uint64_t *digits) {
+	if (!(scaled < digitLimit[FAST_DIGITS + 1])) {
+		return (false);
+	}
+	long double integer = floorl(scaled);
+	long double fraction = scaled - integer;
+	if (fabsl(fraction - 0.5L) <= scaled * ROUNDING_ULPS * LDBL_EPSILON) {
+		return (false);
+	}
+	*digits = (uint64_t) integer + (fraction > 0.5L);
+	return (true);
+}
+
+/**	Rounds the positive value to the given number of significant digits.
+ * @param[in]	value		: the value
+ * @param[in]	count		: number of the significant digits
+ * @param[out]	digits		: the significant digits
+ * @param[out]	exponent	: decimal exponent of the first digit
+ * @return	true if the rounding is certain
+ */
+static bool roundSignificant(double value, int count, uint64_t *digits, int *exponent) {
+	*exponent = (int) floor(ilogb(value) * M_LN2 / M_LN10);
+	for (;; (*exponent)++) {
+		if (!roundScaled(scaleByTen(value, count - 1 - *exponent), digits)) {
+			return (false);
+		}
+		if (*digits < digitLimit[count - 1]) {
+			*exponent -= 2;
+		} else if (*digits < digitLimit[count]) {
+			return (true);
+		}
+	}
+}
+
+/**	Writes the integer as a fixed point number with the given number of fractional digits.
+ * @param[out]	text		: the output
+ * @param[in]	digits		: the digits
+ * @param[in]	precision	: number of the fractional digits
+ * @return	the end of the output
+ */
+static char *writeFixed(char *text, uint64_t digits, int precision) {
+	char reversed[FAST_LENGTH];
+	int length = 0;
+	do {
+		reversed[length++] = (char) ('0' + digits % 10);
+		digits /= 10;
+	} while (digits);
+	while (length <= precision) {
+		reversed[length++] = '0';
+	}
+	while (length) {
+		*text++ = reversed[--length];
+		if (length == precision && precision) {
+			*text++ = '.';
+		}
+	}
+	return (text);
+}
+
+/**	Writes the decimal exponent in printf style.
+ * @param[out]	text		: the output
+ * @param[in]	exponent	: the exponent
+ * @return	the end of the output
+ */
+static char *writeExponent(char *text, int exponent) {
+	*text++ = 'e';
+	*text++ = exponent < 0 ? '-' : '+';
+	exponent = abs(exponent);
+	if (exponent >= 100) {
+		*text++ = (char) ('0' + exponent / 100);
+	}
+	*text++ = (char) ('0' + exponent / 10 % 10);
+	*text++ = (char) ('0' + exponent % 10);
+	return (text);
+}
+
+/**	Removes the trailing zeros of the fraction and the lone decimal point.
+ * @param[in]	begin	: beginning of the number
+ * @param[in]	end		: end of the number
+ * @return	the new end of the number
+ */
+static char *trimZeros(char *begin, char *end) {
+	if (!memchr(begin, '.', (size_t) (end - begin))) {
+		return (end);
+	}
+	while (end[-1] == '0') {
+		end--;
+	}
+	if (end[-1] == '.') {
+		end--;
+	}
+	return (end);
+}
+
+/**	Reads the sign of the positive numbers from the flags of the printf conversion of the format.
+ * @param[in]	format	: the format
+ * @param[out]	sign	: ' ' for the space flag, '\0' for none
+ * @return	false if the conversion has other flags than '-' and ' ', which are left to printf
+ */
+static bool getPositiveSign(const OutputFormat *format, char *sign) {
+	const char *flag = strchr(format->oneNumber, '%');
+	*sign = '\0';
+	for (flag = flag ? flag + 1 : ""; *flag && strchr("-+ #0", *flag); flag++) {
+		if (*flag == ' ') {
+			*sign = ' ';
+		} else if (*flag != '-') {
+			return (false);
+		}
+	}
+	return (true);
+}
+
+/**	Converts the number without padding as the ".Nf", ".Ne" or ".Ng" printf conversions of the format
+ * do, with a leading space for the positive numbers only if the conversion has the space flag.
+ * @param[out]	text	: the output with room for FAST_LENGTH characters
+ * @param[in]	value	: the number
+ * @param[in]	format	: the format
+ * @return	the end of the output or NULL if printf has to convert the number
+ */
+static char *convertFast(char *text, double value, const OutputFormat *format) {
+	char sign;
+	if (!isfinite(value) || !getPositiveSign(format, &sign)) {
+		return (NULL);
+	}
+	if (signbit(value)) {
+		*text++ = '-';
+	} else if (sign) {
+		*text++ = sign;
+	}
+	value = fabs(value);
+	int precision = format->precision;
+	uint64_t digits = 0;
+	int exponent = 0;
+	switch (format->specifier) {
+	case 'f':
+		if (precision > FAST_DIGITS || !roundScaled(scaleByTen(value, precision), &digits)) {
+			return (NULL);
+		}
+		return (writeFixed(text, digits, precision));
+	case 'e':
+		if (precision + 1 > FAST_DIGITS || (value && !roundSignificant(value, precision + 1, &digits, &exponent))) {
+			return (NULL);
+		}
+		return (writeExponent(writeFixed(text, digits, precision), exponent));
+	case 'g':
+		precision = precision ? precision : 1;
+		if (precision > FAST_DIGITS || (value && !roundSignificant(value, precision, &digits, &exponent))) {
+			return (NULL);
+		}
+		if (exponent < precision && exponent >= -4) {
+			return (trimZeros(text, writeFixed(text, digits, precision - 1 - exponent)));
+		}
+		return (writeExponent(trimZeros(text, writeFixed(text, digits, precision - 1)), exponent));
+	default:
+		return (NULL);
+	}
+}
+
+size_t formatDouble(char *buffer, size_t size, double value, const OutputFormat *format) {
+	BACKUP_DEFINITION_LINE(); //
+	assert(buffer || !size);
+	assert(format);
+	SAVE_FUNCTION_FOR_TESTING();
+	char text[FAST_LENGTH];
+	char *end = convertFast(text, value, format);
+	if (!end) {
+		return ((size_t) snprintf(buffer, size, format->oneNumber, value));
+	}
+	size_t length = (size_t) (end - text);
+	size_t padding = format->width > length ? format->width - length : 0;
+	size_t total = length + padding;
+	if (total >= size) {
+		char whole[FAST_LENGTH + MAXIMUM_WIDTH];
+		formatDouble(whole, sizeof(whole), value, format);
+		if (size) {
+			memcpy(buffer, whole, size - 1);
+			buffer[size - 1] = '\0';
+		}
+		return (total);
+	}
+	if (format->leftJustified) {
+		memcpy(buffer, text, length);
+		memset(buffer + length, ' ', padding);
+	} else {
+		memset(buffer, ' ', padding);
+		memcpy(buffer + padding, text, length);
+	}
+	buffer[total] = '\0';
+	return (total);
+}
+
+const OutputFormat rowFormat = { 5, 11, 11 + SEPARATOR_LENGTH, 'g', ' ', false, "%11.5lg", "%11s" };
+
+void printDoubles(FILE *file, const double number[], size_t count, const OutputFormat *format, char end) {
+	char text[FAST_LENGTH + MAXIMUM_WIDTH];
+	for (size_t current = 0; current < count; current++) {
+		size_t length = formatDouble(text, sizeof(text), number[current], format);
+		length = length < sizeof(text) - 1 ? length : sizeof(text) - 2;
+		text[length] = current + 1 < count ? format->separator : end;
+		fwrite(text, 1, length + 1, file);
+	}
+}
+
+///@}
+
 /*
  static void printFormat(FILE *file, OutputFormat *format) {
  fprintf(file, "prefision:             %u\n", format->precision);
@@ -287,8 +536,50 @@ static bool isOK_setFormat(void) {
 	return (true);
 }
 
+static bool isOK_formatDouble(void) {
+	OutputFormat format;
+	char specifier[] = { 'g', 'e', 'f' };
+	double value[] = { 0.0, -0.0, 0.5, 2.5, 9.99995, 99999.5, 1.0 / 3.0, -3.25e-7, 1e-300, 5e-324, 1e22, 1e100,
+		1.2345e100, -1.2345e100, 1.7976931348623157e308, NAN, INFINITY };
+	const OutputFormat unsigned16 = { 10, 16, 16 + SEPARATOR_LENGTH, 'g', ' ', false, "%16.10lg", "%16s" };
+	const OutputFormat *fixed[] = { &rowFormat, &unsigned16 };
+	nameString output, result;
+	for (ushort i = 0; i < sizeof(fixed) / sizeof(fixed[0]); i++) {
+		for (ushort j = 0; j < sizeof(value) / sizeof(value[0]); j++) {
+			snprintf(result, NAMES_LENGTH, fixed[i]->oneNumber, value[j]);
+			SAVE_FUNCTION_CALLER();
+			formatDouble(output, NAMES_LENGTH, value[j], fixed[i]);
+			if (strcmp(result, output)) {
+				PRINT_ERROR();
+				return (false);
+			}
+		}
+	}
+	for (ushort i = 0; i < sizeof(specifier); i++) {
+		for (ushort precision = 0; precision < 20; precision += 3) {
+			setOutputFormat(&format, precision, 11, specifier[i], ' ', precision % 2);
+			for (ushort j = 0; j < sizeof(value) / sizeof(value[0]); j++) {
+				if (specifier[i] == 'f' && fabs(value[j]) > 1e30) {
+					continue;
+				}
+				snprintf(result, NAMES_LENGTH, format.oneNumber, value[j]);
+				SAVE_FUNCTION_CALLER();
+				formatDouble(output, NAMES_LENGTH, value[j], &format);
+				if (strcmp(result, output)) {
+					PRINT_ERROR();
+					return (false);
+				}
+			}
+		}
+	}
+	PRINT_OK();
+	return (true);
+}
+
 bool areIOFunctionsGood(void) {
-	if (isOK_setFormat()) {
+	bool isOK = isOK_setFormat();
+	isOK = isOK_formatDouble() && isOK;
+	if (isOK) {
 		PRINT_OK_FILE();
 		return (true);
 	}
@@ -8,6 +8,7 @@
 #include <math.h>
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include "test.h"
 #include "util_math.h"
@@ -112,6 +113,70 @@ double randomBetween(double bottom, double top) {
 	return ((top - bottom) * randomBetweenZeroAndOne() + bottom);
 }
 
+void philox(const uint32_t key[2], const uint32_t counter[4], uint32_t block[4]) {
+	uint32_t round[2] = { key[0], key[1] };
+	uint32_t word[4] = { counter[0], counter[1], counter[2], counter[3] };
+	for (int current = 0; current < 10; current++) {
+		uint64_t first = (uint64_t) 0xD2511F53u * word[0];
+		uint64_t second = (uint64_t) 0xCD9E8D57u * word[2];
+		uint32_t next[4] = { (uint32_t) (second >> 32) ^ word[1] ^ round[0], (uint32_t) second,
+		        (uint32_t) (first >> 32) ^ word[3] ^ round[1], (uint32_t) first };
+		memcpy(word, next, sizeof(word));
+		round[0] += 0x9E3779B9u;
+		round[1] += 0xBB67AE85u;
+	}
+	memcpy(block, word, sizeof(word));
+}
+
+void initializeRandomStream(RandomStream *stream, uint64_t seed, uint64_t index) {
+	memset(stream, 0, sizeof(RandomStream));
+	stream->key[0] = (uint32_t) seed;
+	stream->key[1] = (uint32_t) (seed >> 32);
+	stream->counter[2] = (uint32_t) index;
+	stream->counter[3] = (uint32_t) (index >> 32);
+	stream->used = 4;
+}
+
+double randomStreamUniform(RandomStream *stream) {
+	if (stream->used > 2) {
+		philox(stream->key, stream->counter, stream->block);
+		if (!++stream->counter[0]) {
+			stream->counter[1]++;
+		}
+		stream->used = 0;
+	}
+	uint64_t bits = (uint64_t) stream->block[stream->used] << 32 | stream->block[stream->used + 1];
+	stream->used += 2;
+	return ((double) (bits >> 11) * 0x1.0p-53);
+}
+
+double randomStreamBetween(RandomStream *stream, double bottom, double top) {
+	return ((top - bottom) * randomStreamUniform(stream) + bottom);
+}
+
+///@}
+/// @name Order statistics
+///@{
+
+int compareDoubles(const void *left, const void *right) {
+	double difference = *(const double *) left - *(const double *) right;
+	return ((difference > 0.0) - (difference < 0.0));
+}
+
+double getSortedPercentile(const double sorted[], size_t length, double fraction) {
+	double position = fraction * (double) (length - 1);
+	size_t lower = (size_t) position;
+	if (lower + 1 >= length) {
+		return (sorted[length - 1]);
+	}
+	return (sorted[lower] + (position - (double) lower) * (sorted[lower + 1] - sorted[lower]));
+}
+
+double getMedian(double value[], size_t length) {
+	qsort(value, length, sizeof(double), compareDoubles);
+	return (getSortedPercentile(value, length, 0.5));
+}
+
 ///@}
 
 const double EPSILON = 1.776356839400251e-15;
@@ -219,6 +284,36 @@ bool isOK_randomBetween(void) {
 	return true;
 }
 
+bool isOK_philox(void) {
+	static const uint32_t key[][2] = { { 0, 0 }, { 0xffffffff, 0xffffffff } };
+	static const uint32_t counter[][4] = { { 0, 0, 0, 0 }, { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff } };
+	static const uint32_t expected[][4] = { { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 },
+	        { 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd } };
+	for (ushort i = ZERO; i < 2; i++) {
+		uint32_t block[4];
+		SAVE_FUNCTION_CALLER();
+		philox(key[i], counter[i], block);
+		if (memcmp(block, expected[i], sizeof(block))) {
+			PRINT_ERROR();
+			return false;
+		}
+	}
+	PRINT_OK();
+	return true;
+}
+
+bool isOK_getSortedPercentile(void) {
+	double odd[] = { 3.0, 1.0, 2.0 }, even[] = { 4.0, 1.0, 3.0, 2.0 };
+	SAVE_FUNCTION_CALLER();
+	if (getMedian(odd, 3) != 2.0 || getMedian(even, 4) != 2.5 || getSortedPercentile(even, 4, 0.0) != 1.0
+	        || getSortedPercentile(even, 4, 1.0) != 4.0 || !isNear(getSortedPercentile(even, 4, 0.95), 3.85, 1e-12)) {
+		PRINT_ERROR();
+		return false;
+	}
+	PRINT_OK();
+	return true;
+}
+
 bool areUtilMathFunctionsOK(void) {
 	bool isOK = true;
 	if (!isOK_randomBetweenZeroAndN()) {
@@ -227,6 +322,12 @@ bool areUtilMathFunctionsOK(void) {
 	if (!isOK_randomBetween()) {
 		isOK = false;
 	}
+	if (!isOK_philox()) {
+		isOK = false;
+	}
+	if (!isOK_getSortedPercentile()) {
+		isOK = false;
+	}
 	if (isOK) {
 		PRINT_OK_FILE();
 	} else {
@@ -0,0 +1,305 @@
+/**	@file   writer.c
+ *	@author László Veréb
+ *	@date   18.10.2026
+ *	@brief  Buffered output written by a background thread.
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include "queue.h"
+#include "writer.h"
+
+enum {
+	QUEUED_BLOCKS = 16,	///< number of the buffers waiting for the I/O thread, blocks the producers beyond.
+	SPARE_BLOCKS = QUEUED_BLOCKS,	///< number of the written buffers kept for reuse.
+	VECTOR = 16,	///< maximal number of the buffers written by one writev.
+};
+
+struct WriterBlock {
+	Writer *writer;	///< owner of the data.
+	char *data;	///< the data, aligned for the direct I/O.
+	size_t length;	///< number of the bytes to write.
+	bool last;	///< the file is closed after the block.
+};
+
+/** State of the I/O thread. */
+static struct {
+	pthread_once_t once;	///< starts the thread.
+	pthread_t thread;	///< the I/O thread.
+	Queue *queued;	///< blocks waiting to be written.
+	Queue *spare;	///< written blocks for reuse.
+	sem_t ready;	///< number of the queued blocks.
+	pthread_mutex_t lock;	///< protects the counter of the pending blocks.
+	pthread_cond_t drained;	///< signalled when there are no pending blocks.
+	size_t pending;	///< number of the blocks handed off but not yet written.
+	int failure;	///< FAILURE if any write failed.
+} io = { PTHREAD_ONCE_INIT, .lock = PTHREAD_MUTEX_INITIALIZER, .drained = PTHREAD_COND_INITIALIZER };
+
+static WriterBlock *getBlock(Writer *writer) {
+	WriterBlock *block;
+	size_t unused;
+	if (!tryDequeue(io.spare, &unused, (void **) &block)) {
+		block = malloc(sizeof(WriterBlock));
+		if (!block || posix_memalign((void **) &block->data, WRITER_SLACK, WRITER_BLOCK + WRITER_SLACK)) {
+			fprintf(stderr, "Couldn't allocate output buffer; %s\n", strerror(ENOMEM));
+			exit(EXIT_FAILURE);
+		}
+	}
+	block->writer = writer;
+	block->length = 0;
+	block->last = false;
+	return (block);
+}
+
+static void recycleBlock(WriterBlock *block) {
+	if (!tryEnqueue(io.spare, 0, block)) {
+		free(block->data);
+		free(block);
+	}
+}
+
+/**
+ * Writes the vector completely, continues after the partial writes and the interrupts.
+ * @param[in] writer the file.
+ * @param[in] vector the buffers.
+ * @param[in] count  number of the buffers.
+ * @return failure code
+ */
+static int writeVector(Writer *writer, struct iovec vector[], int count) {
+	while (count) {
+		ssize_t written = writev(writer->descriptor, vector, count);
+		if (written < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			fprintf(stderr, "Couldn't write file %s; %s\n", writer->path, strerror(errno));
+			return (FAILURE);
+		}
+		while (count && (size_t) written >= vector->iov_len) {
+			written -= vector->iov_len;
+			vector++;
+			count--;
+		}
+		if (count) {
+			vector->iov_base = (char *) vector->iov_base + written;
+			vector->iov_len -= written;
+		}
+	}
+	return (SUCCESS);
+}
+
+/**
+ * Writes the blocks of one file, the length of the direct I/O has to be a multiple of the alignment,
+ * so the unaligned tail of the last block is written after switching it off.
+ * @param[in] block the blocks.
+ * @param[in] count number of the blocks.
+ * @return failure code
+ */
+static int writeBlocks(WriterBlock *block[], int count) {
+	Writer *writer = block[0]->writer;
+	struct iovec vector[VECTOR];
+	for (int current = 0; current < count; current++) {
+		vector[current] = (struct iovec ) { block[current]->data, block[current]->length };
+	}
+	size_t tail = 0;
+	if (writer->direct && block[count - 1]->last) {
+		tail = vector[count - 1].iov_len % WRITER_SLACK;
+		vector[count - 1].iov_len -= tail;
+	}
+	int failure = writeVector(writer, vector, count);
+	if (tail && !failure) {
+		fcntl(writer->descriptor, F_SETFL, fcntl(writer->descriptor, F_GETFL) & ~O_DIRECT);
+		vector[0] = (struct iovec ) { block[count - 1]->data + block[count - 1]->length - tail, tail };
+		failure = writeVector(writer, vector, 1);
+	}
+	return (failure);
+}
+
+static void finishBlocks(WriterBlock *block[], int count, int failure) {
+	Writer *writer = block[0]->writer;
+	if (block[count - 1]->last) {
+		if (close(writer->descriptor)) {
+			fprintf(stderr, "Couldn't close file %s; %s\n", writer->path, strerror(errno));
+			failure = FAILURE;
+		}
+		free(writer);
+	}
+	for (int current = 0; current < count; current++) {
+		recycleBlock(block[current]);
+	}
+	pthread_mutex_lock(&io.lock);
+	io.failure |= failure;
+	io.pending -= count;
+	if (!io.pending) {
+		pthread_cond_broadcast(&io.drained);
+	}
+	pthread_mutex_unlock(&io.lock);
+}
+
+/**
+ * Takes the next queued block.
+ * @param[in] wait waits for the block if true.
+ * @return the block or NULL if none is queued and not waiting.
+ */
+static WriterBlock *takeBlock(bool wait) {
+	WriterBlock *block;
+	size_t unused;
+	if (wait) {
+		while (sem_wait(&io.ready)) {
+		}
+	} else if (sem_trywait(&io.ready)) {
+		return (NULL);
+	}
+	dequeue(io.queued, &unused, (void **) &block);
+	return (block);
+}
+
+/**
+ * Writes the queued blocks, the consecutive blocks of the same file are gathered into one writev.
+ * @param[in] argument unused.
+ * @return NULL
+ */
+static void *writeQueued(void *argument) {
+	(void) argument;
+	WriterBlock *block[VECTOR], *next = NULL;
+	for (;;) {
+		int count = 0;
+		block[count++] = next ? next : takeBlock(true);
+		next = NULL;
+		while (!block[count - 1]->last && count < VECTOR && (next = takeBlock(false))) {
+			if (next->writer != block[0]->writer) {
+				break;
+			}
+			block[count++] = next;
+			next = NULL;
+		}
+		finishBlocks(block, count, writeBlocks(block, count));
+	}
+	return (NULL);
+}
+
+static void startWriterThread(void) {
+	io.queued = createQueue(QUEUED_BLOCKS);
+	io.spare = createQueue(SPARE_BLOCKS);
+	sem_init(&io.ready, 0, 0);
+	if (pthread_create(&io.thread, NULL, writeQueued, NULL)) {
+		fprintf(stderr, "Couldn't start the output thread.\n");
+		exit(EXIT_FAILURE);
+	}
+	pthread_detach(io.thread);
+}
+
+Writer *openWriter(const char *path, WriterMode mode) {
+	pthread_once(&io.once, startWriterThread);
+	Writer *writer = calloc(1, sizeof(Writer));
+	int flags = O_WRONLY | O_CREAT | O_TRUNC;
+	strncpy(writer->path, path, sizeof(string) - 1);
+	writer->direct = mode == WRITER_DIRECT;
+	writer->descriptor = open(path, flags | (writer->direct ? O_DIRECT : 0), 0644);
+	if (writer->descriptor < 0 && writer->direct && errno == EINVAL) {
+		writer->direct = false;
+		writer->descriptor = open(path, flags, 0644);
+	}
+	if (writer->descriptor < 0) {
+		fprintf(stderr, "Couldn't open file %s for writing; %s\n", path, strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+	writer->block = getBlock(writer);
+	writer->data = writer->block->data;
+	return (writer);
+}
+
+/**
+ * Hands the block to the I/O thread.
+ * @param[in] block the block.
+ */
+static void queueBlock(WriterBlock *block) {
+	pthread_mutex_lock(&io.lock);
+	io.pending++;
+	pthread_mutex_unlock(&io.lock);
+	enqueue(io.queued, 0, block);
+	sem_post(&io.ready);
+}
+
+void passBlock(Writer *writer) {
+	WriterBlock *full = writer->block;
+	size_t overflow = writer->used > WRITER_BLOCK ? writer->used - WRITER_BLOCK : 0;
+	full->length = writer->used - overflow;
+	writer->block = getBlock(writer);
+	writer->data = writer->block->data;
+	memcpy(writer->data, full->data + full->length, overflow);
+	writer->used = overflow;
+	queueBlock(full);
+}
+
+void closeWriter(Writer **writer) {
+	WriterBlock *block = (*writer)->block;
+	block->length = (*writer)->used;
+	block->last = true;
+	*writer = NULL;
+	queueBlock(block);
+}
+
+void writeBytes(Writer *writer, const char *data, size_t length) {
+	while (length) {
+		size_t room = WRITER_BLOCK - writer->used;
+		size_t copied = length < room ? length : room;
+		memcpy(writer->data + writer->used, data, copied);
+		writer->used += copied;
+		data += copied;
+		length -= copied;
+		if (writer->used >= WRITER_BLOCK) {
+			passBlock(writer);
+		}
+	}
+}
+
+void writeFormatted(Writer *writer, const char *format, ...) {
+	va_list arguments;
+	va_start(arguments, format);
+	char *room = reserveWriter(writer);
+	size_t space = WRITER_BLOCK + WRITER_SLACK - writer->used;
+	int length = vsnprintf(room, space, format, arguments);
+	va_end(arguments);
+	if (length < 0) {
+		return;
+	}
+	if ((size_t) length < space) {
+		writer->used += length;
+		return;
+	}
+	char *text = malloc(length + 1);
+	va_start(arguments, format);
+	vsnprintf(text, length + 1, format, arguments);
+	va_end(arguments);
+	writeBytes(writer, text, length);
+	free(text);
+}
+
+void writeDoubles(Writer *writer, const double number[], size_t count, const OutputFormat *format, char end) {
+	for (size_t current = 0; current < count; current++) {
+		char *room = reserveWriter(writer);
+		size_t length = formatDouble(room, WRITER_SLACK, number[current], format);
+		writer->used += length < WRITER_SLACK - 1 ? length : WRITER_SLACK - 2;
+		writer->data[writer->used++] = current + 1 < count ? format->separator : end;
+	}
+}
+
+int flushWriters(void) {
+	pthread_mutex_lock(&io.lock);
+	while (io.pending) {
+		pthread_cond_wait(&io.drained, &io.lock);
+	}
+	int failure = io.failure;
+	pthread_mutex_unlock(&io.lock);
+	return (failure);
+}